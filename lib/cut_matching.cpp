@@ -14,9 +14,12 @@ Result::Result()
     : type(Result::Type::Expander), iterations(0),
       iterationsUntilValidExpansion(INT_MAX), congestion(1) {}
 
-Solver::Solver(UnitFlow::Graph *g, UnitFlow::Graph *subdivG,
-               std::mt19937 *randomGen, std::vector<int> *subdivisionIdx,
-               double phi, Parameters params)
+template <typename V>
+BasicSolver<V>::BasicSolver(UnitFlow::BasicGraph<V> *g,
+                            SubdivisionFlow::BasicGraph<V> *subdivG,
+                            std::mt19937 *randomGen,
+                            std::vector<V> *subdivisionIdx, double phi,
+                            Parameters params)
     : graph(g), subdivGraph(subdivG), randomGen(randomGen),
       subdivisionIdx(subdivisionIdx), phi(phi),
       T(std::max(1, params.tConst + int(ceil(params.tFactor *square(
@@ -25,24 +28,21 @@ Solver::Solver(UnitFlow::Graph *g, UnitFlow::Graph *subdivG,
   assert(graph->size() != 0 && "Cut-matching expected non-empty subset.");
 
   // Set edge capacities in subdivision flow graph.
-  const UnitFlow::Flow capacity = std::ceil(1.0 / phi / T);
-  for (auto u : *graph)
-    for (auto e = subdivGraph->beginEdge(u); e != subdivGraph->endEdge(u); ++e)
-      e->capacity = capacity, subdivGraph->reverse(*e).capacity = capacity,
-      e->congestion = 0, subdivGraph->reverse(*e).congestion = 0;
+  subdivGraph->setCapacity(UnitFlow::Flow(std::ceil(1.0 / phi / T)));
+  subdivGraph->resetCongestion();
 
   // If potential is sampled, set the flow matrix to the identity matrix.
   if (params.samplePotential) {
     flowMatrix.resize(subdivGraph->size());
-    for (int u : *subdivGraph)
+    for (V u : *subdivGraph)
       flowMatrix[u].resize(subdivGraph->size());
 
-    for (int i = 0; i < subdivGraph->size(); ++i)
+    for (V i = 0; i < subdivGraph->size(); ++i)
       flowMatrix[i][i] = 1.0;
   }
 
   // Give each 'm' subdivision vertex a unique index in the range '[0,m)'.
-  int count = 0;
+  V count = 0;
   for (auto u : *subdivGraph) {
     if ((*subdivisionIdx)[u] >= 0) {
       (*subdivisionIdx)[u] = count++;
@@ -50,7 +50,7 @@ Solver::Solver(UnitFlow::Graph *g, UnitFlow::Graph *subdivG,
   }
 }
 
-std::vector<double> Solver::randomUnitVector() {
+template <typename V> std::vector<double> BasicSolver<V>::randomUnitVector() {
   std::normal_distribution<> distr(0, 1);
 
   std::vector<double> result(numSplitNodes);
@@ -70,9 +70,9 @@ std::vector<double> Solver::randomUnitVector() {
   return result;
 }
 
-double Solver::samplePotential() const {
+template <typename V> double BasicSolver<V>::samplePotential() const {
   // Subdivision vertices remaining.
-  std::vector<int> alive;
+  std::vector<V> alive;
   for (auto it = subdivGraph->cbegin(); it != subdivGraph->cend(); ++it) {
     const auto u = (*subdivisionIdx)[*it];
     if (u >= 0)
@@ -81,15 +81,15 @@ double Solver::samplePotential() const {
 
   std::vector<long double> avgFlowVector(numSplitNodes);
 
-  for (int u : alive)
-    for (int v : alive)
+  for (V u : alive)
+    for (V v : alive)
       avgFlowVector[v] += flowMatrix[u][v];
   for (auto &f : avgFlowVector)
     f /= (long double)alive.size();
 
   long double sum = 0, kahanError = 0;
-  for (int u : alive) {
-    for (int v : alive) {
+  for (V u : alive) {
+    for (V v : alive) {
       const long double sq = square(flowMatrix[u][v] - avgFlowVector[v]);
       const long double y = sq - kahanError;
       const long double t = sum + y;
@@ -101,15 +101,16 @@ double Solver::samplePotential() const {
   return (double)sum;
 }
 
-std::pair<std::vector<int>, std::vector<int>>
-Solver::proposeCut(const std::vector<double> &flow,
-                   const Parameters &params) const {
-  const int curSubdivisionCount = subdivGraph->size() - graph->size();
+template <typename V>
+std::pair<std::pmr::vector<V>, std::pmr::vector<V>>
+BasicSolver<V>::proposeCut(const std::vector<double> &flow,
+                           const Parameters &params) {
+  const V curSubdivisionCount = subdivGraph->size() - graph->size();
   double avgFlow;
   {
     double sum = 0, kahanError = 0;
     for (auto u : *subdivGraph) {
-      const int idx = (*subdivisionIdx)[u];
+      const V idx = (*subdivisionIdx)[u];
       if (idx >= 0) {
         const double y = flow[idx] - kahanError;
         const double t = sum + y;
@@ -120,9 +121,9 @@ Solver::proposeCut(const std::vector<double> &flow,
     avgFlow = sum / (double)curSubdivisionCount;
   }
   // Partition subdivision vertices into a left and right set.
-  std::vector<int> axLeft, axRight;
+  std::pmr::vector<V> axLeft(&arena), axRight(&arena);
   for (auto u : *subdivGraph) {
-    const int idx = (*subdivisionIdx)[u];
+    const V idx = (*subdivisionIdx)[u];
     if (idx >= 0) {
       if (flow[idx] < avgFlow)
         axLeft.push_back(u);
@@ -132,7 +133,7 @@ Solver::proposeCut(const std::vector<double> &flow,
   }
 
   // Sort by flow
-  auto cmpFlow = [&flow, &subdivisionIdx = subdivisionIdx](int u, int v) {
+  auto cmpFlow = [&flow, &subdivisionIdx = subdivisionIdx](V u, V v) {
     return flow[(*subdivisionIdx)[u]] < flow[(*subdivisionIdx)[v]];
   };
   std::sort(axLeft.begin(), axLeft.end(), cmpFlow);
@@ -151,12 +152,12 @@ Solver::proposeCut(const std::vector<double> &flow,
   // Compute potentials
   double totalPotential = 0.0, leftPotential = 0.0;
   for (auto u : *subdivGraph) {
-    const int idx = (*subdivisionIdx)[u];
+    const V idx = (*subdivisionIdx)[u];
     if (idx >= 0)
       totalPotential += square(flow[idx] - avgFlow);
   }
   for (auto u : axLeft) {
-    const int idx = (*subdivisionIdx)[u];
+    const V idx = (*subdivisionIdx)[u];
     assert(idx >= 0);
     leftPotential += square(flow[idx] - avgFlow);
   }
@@ -164,7 +165,7 @@ Solver::proposeCut(const std::vector<double> &flow,
   if (leftPotential <= totalPotential / 20.0) {
     double l = 0.0;
     for (auto u : axLeft) {
-      const int idx = (*subdivisionIdx)[u];
+      const V idx = (*subdivisionIdx)[u];
       assert(idx >= 0);
       l += std::abs(flow[idx] - avgFlow);
     }
@@ -173,7 +174,7 @@ Solver::proposeCut(const std::vector<double> &flow,
     // Re-partition along '\mu'.
     axLeft.clear(), axRight.clear();
     for (auto u : *subdivGraph) {
-      const int idx = (*subdivisionIdx)[u];
+      const V idx = (*subdivisionIdx)[u];
       if (idx >= 0) {
         if (flow[idx] <= mu)
           axRight.push_back(u);
@@ -188,26 +189,34 @@ Solver::proposeCut(const std::vector<double> &flow,
     while (axRight.size() > axLeft.size())
       axRight.pop_back();
   } else {
-    while ((int)axLeft.size() * 8 > curSubdivisionCount)
+    while (V(axLeft.size()) * 8 > curSubdivisionCount)
       axLeft.pop_back();
   }
   while (axLeft.size() > axRight.size())
     axLeft.pop_back();
 
-  return std::make_pair(axLeft, axRight);
+  return std::make_pair(std::move(axLeft), std::move(axRight));
 }
 
-Result Solver::compute(Parameters params) {
+template <typename V> Memory::Usage BasicSolver<V>::memoryUsage() const {
+  Memory::Usage usage;
+  usage.add("flowMatrix", Memory::bytes(flowMatrix));
+  usage.add("arena", arena.capacity());
+  return usage;
+}
+
+template <typename V> Result BasicSolver<V>::compute(Parameters params) {
   if (numSplitNodes <= 1) {
     VLOG(3) << "Cut matching exited early with " << numSplitNodes
             << " subdivision vertices.";
     return Result{};
   }
 
-  const int totalVolume = subdivGraph->globalVolume();
-  const int lowerVolumeBalance = totalVolume / 2 / 10 / T;
-  const int targetVolumeBalance =
-      std::max(lowerVolumeBalance, int(params.minBalance * totalVolume));
+  const UnitFlow::Volume totalVolume = subdivGraph->globalVolume();
+  const UnitFlow::Volume lowerVolumeBalance = totalVolume / 2 / 10 / T;
+  const UnitFlow::Volume targetVolumeBalance =
+      std::max(lowerVolumeBalance,
+               UnitFlow::Volume(params.minBalance * double(totalVolume)));
 
   Result result;
   auto flow = randomUnitVector();
@@ -215,18 +224,17 @@ Result Solver::compute(Parameters params) {
   int iterations = 0;
   const int iterationsToRun = std::max(params.minIterations, T);
   for (; iterations < iterationsToRun &&
-         subdivGraph->globalVolume(subdivGraph->cbeginRemoved(),
-                                   subdivGraph->cendRemoved()) <=
-             targetVolumeBalance;
+         subdivGraph->removedGlobalVolume() <= targetVolumeBalance;
        ++iterations) {
     VLOG(3) << "Iteration " << iterations << " out of " << iterationsToRun
             << ".";
+    arena.reset();
 
     if (params.samplePotential) {
       VLOG(4) << "Sampling potential function";
       double p = samplePotential();
       result.sampledPotentials.push_back(p);
-      if (p < 1.0 / (16.0 * square(numSplitNodes)))
+      if (p < 1.0 / (16.0 * square(double(numSplitNodes))))
         result.iterationsUntilValidExpansion =
             std::min(result.iterationsUntilValidExpansion, iterations);
       VLOG(4) << "Finished sampling potential function";
@@ -248,7 +256,7 @@ Result Solver::compute(Parameters params) {
             << " |T| = " << axRight.size() << " and max height " << h << ".";
     const auto hasExcess = subdivGraph->compute(h);
 
-    std::unordered_set<int> removed;
+    std::pmr::unordered_set<V> removed(&arena);
     if (hasExcess.empty()) {
       VLOG(3) << "\tAll flow routed.";
     } else {
@@ -270,7 +278,7 @@ Result Solver::compute(Parameters params) {
 
     VLOG(3) << "\tRemoving " << removed.size() << " vertices.";
 
-    auto isRemoved = [&removed](int u) {
+    auto isRemoved = [&removed](V u) {
       return removed.find(u) != removed.end();
     };
     axLeft.erase(std::remove_if(axLeft.begin(), axLeft.end(), isRemoved),
@@ -284,7 +292,7 @@ Result Solver::compute(Parameters params) {
       subdivGraph->remove(u);
     }
 
-    std::vector<int> zeroDegrees;
+    std::pmr::vector<V> zeroDegrees(&arena);
     for (auto it = subdivGraph->cbegin(); it != subdivGraph->cend(); ++it)
       if (subdivGraph->degree(*it) == 0)
         zeroDegrees.push_back(*it), removed.insert(*it);
@@ -296,18 +304,17 @@ Result Solver::compute(Parameters params) {
 
     VLOG(3) << "Computing matching with |S| = " << axLeft.size()
             << " |T| = " << axRight.size() << ".";
-    auto matching =
-        subdivGraph->matching(axLeft, UnitFlow::Graph::MatchingMethod::Dfs);
+    auto matching = subdivGraph->matching(axLeft.begin(), axLeft.end());
     for (auto &p : matching) {
-      int u = (*subdivisionIdx)[p.first];
-      int v = (*subdivisionIdx)[p.second];
+      V u = (*subdivisionIdx)[p.first];
+      V v = (*subdivisionIdx)[p.second];
 
       flow[u] = 0.5 * (flow[u] + flow[v]);
       flow[v] = flow[u];
 
       if (params.samplePotential) {
-        for (int i : *subdivGraph) {
-          int w = (*subdivisionIdx)[i];
+        for (V i : *subdivGraph) {
+          V w = (*subdivisionIdx)[i];
           if (w >= 0) {
             flowMatrix[u][w] = 0.5 * (flowMatrix[u][w] + flowMatrix[v][w]);
             flowMatrix[v][w] = flowMatrix[u][w];
@@ -319,10 +326,7 @@ Result Solver::compute(Parameters params) {
   }
 
   result.iterations = iterations;
-  result.congestion = 1;
-  for (auto u : *subdivGraph)
-    for (auto e = subdivGraph->beginEdge(u); e != subdivGraph->endEdge(u); ++e)
-      result.congestion = std::max(result.congestion, e->congestion);
+  result.congestion = std::max<long long>(1, subdivGraph->congestion());
 
   if (params.samplePotential) {
     VLOG(4) << "Final sampling of potential function";
@@ -331,9 +335,7 @@ Result Solver::compute(Parameters params) {
   }
 
   if (graph->size() != 0 && graph->removedSize() != 0 &&
-      subdivGraph->globalVolume(subdivGraph->cbeginRemoved(),
-                                subdivGraph->cendRemoved()) >
-          lowerVolumeBalance)
+      subdivGraph->removedGlobalVolume() > lowerVolumeBalance)
     // We have: graph.volume(R) > m / (10 * T)
     result.type = Result::Balanced;
   else if (graph->removedSize() == 0)
@@ -348,8 +350,7 @@ Result Solver::compute(Parameters params) {
     VLOG(2) << "Cut matching ran " << iterations
             << " iterations and resulted in balanced cut with size ("
             << graph->size() << ", " << graph->removedSize() << ") and volume ("
-            << graph->globalVolume(graph->cbegin(), graph->cend()) << ", "
-            << graph->globalVolume(graph->cbeginRemoved(), graph->cendRemoved())
+            << graph->globalVolume() << ", " << graph->removedGlobalVolume()
             << ").";
     break;
   }
@@ -368,4 +369,7 @@ Result Solver::compute(Parameters params) {
 
   return result;
 }
+
+template class BasicSolver<int32_t>;
+template class BasicSolver<int64_t>;
 } // namespace CutMatching
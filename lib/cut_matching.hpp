@@ -1,8 +1,12 @@
 #pragma once
 
+#include <memory_resource>
 #include <random>
 #include <vector>
 
+#include "datastructures/arena.hpp"
+#include "datastructures/memory.hpp"
+#include "datastructures/subdivision_flow.hpp"
 #include "datastructures/undirected_graph.hpp"
 #include "datastructures/unit_flow.hpp"
 #include "util.hpp"
@@ -98,17 +102,20 @@ struct Result {
  */
 using Matching = std::vector<std::pair<int, int>>;
 
-class Solver {
+/**
+   Cut-matching game on flow graphs with vertex indices of type 'V'.
+ */
+template <typename V> class BasicSolver {
 private:
-  UnitFlow::Graph *graph;
-  UnitFlow::Graph *subdivGraph;
+  UnitFlow::BasicGraph<V> *graph;
+  SubdivisionFlow::BasicGraph<V> *subdivGraph;
 
   /**
      Randomness generator.
    */
   std::mt19937 *randomGen;
 
-  std::vector<int> *subdivisionIdx;
+  std::vector<V> *subdivisionIdx;
 
   const double phi;
   const int T;
@@ -116,7 +123,7 @@ private:
   /**
      Number of subdivision vertices at beginning of computation.
    */
-  const int numSplitNodes;
+  const V numSplitNodes;
 
   /**
      Matrix representing multi-commodity flow. Only constructed if potential is
@@ -124,6 +131,11 @@ private:
    */
   std::vector<std::vector<double>> flowMatrix;
 
+  /**
+     Backs the temporaries of each iteration and is reset at its start.
+   */
+  Arena::Resource arena;
+
   /**
      Construct a semi-random vector for the currently alive subdivision vertices
      with length 'numSplitNodes' normalized by the number of alive subdivision
@@ -138,9 +150,10 @@ private:
 
   /**
      Create a cut according to the cut player strategy given the current flow.
+     The cut is allocated in 'arena'.
    */
-  std::pair<std::vector<int>, std::vector<int>>
-  proposeCut(const std::vector<double> &flow, const Parameters &params) const;
+  std::pair<std::pmr::vector<V>, std::pmr::vector<V>>
+  proposeCut(const std::vector<double> &flow, const Parameters &params);
 
 public:
   /**
@@ -162,13 +175,24 @@ public:
 
      - params: Algorithm configuration.
    */
-  Solver(UnitFlow::Graph *g, UnitFlow::Graph *subdivGraph,
-         std::mt19937 *randomGen, std::vector<int> *subdivisionIdx, double phi,
-         Parameters params);
+  BasicSolver(UnitFlow::BasicGraph<V> *g,
+              SubdivisionFlow::BasicGraph<V> *subdivGraph,
+              std::mt19937 *randomGen, std::vector<V> *subdivisionIdx,
+              double phi, Parameters params);
 
   /**
      Compute a sparse cut.
    */
   Result compute(Parameters params);
+
+  /**
+     Bytes allocated by the solver, excluding the graphs it was given.
+   */
+  Memory::Usage memoryUsage() const;
 };
+
+using Solver = BasicSolver<int>;
+
+extern template class BasicSolver<int32_t>;
+extern template class BasicSolver<int64_t>;
 }; // namespace CutMatching
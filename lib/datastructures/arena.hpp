@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace Arena {
+
+/**
+   Bump allocator for temporaries which are released all at once. Allocations
+   are carved from large blocks and deallocation does nothing. 'reset'
+   releases everything allocated, but keeps a single block large enough to
+   hold all of it, such that repeating the same work after a reset does not
+   allocate from the heap.
+
+   Intended as the resource of 'std::pmr' containers which live until the
+   next 'reset', e.g. the temporaries of one iteration of an algorithm.
+ */
+class Resource : public std::pmr::memory_resource {
+private:
+  /**
+     Blocks of memory and their sizes. Allocations are taken from the last
+     block, starting at 'offset'.
+   */
+  std::vector<std::pair<std::unique_ptr<std::byte[]>, size_t>> blocks;
+  size_t offset = 0;
+
+  /**
+     Size of the first block allocated.
+   */
+  static constexpr size_t minBlockSize = 4096;
+
+  void addBlock(size_t size) {
+    blocks.emplace_back(new std::byte[size], size);
+    offset = 0;
+  }
+
+protected:
+  void *do_allocate(size_t bytes, size_t alignment) override {
+    if (!blocks.empty()) {
+      auto &[block, size] = blocks.back();
+      void *p = block.get() + offset;
+      size_t space = size - offset;
+      if (std::align(alignment, bytes, p, space)) {
+        offset = size - space + bytes;
+        return p;
+      }
+    }
+
+    // A new block has room for the allocation however it is aligned.
+    const size_t lastSize = blocks.empty() ? 0 : blocks.back().second;
+    addBlock(std::max({minBlockSize, 2 * lastSize, bytes + alignment}));
+    return do_allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void *, size_t, size_t) override {}
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override {
+    return this == &other;
+  }
+
+public:
+  Resource() = default;
+  Resource(const Resource &) = delete;
+  Resource &operator=(const Resource &) = delete;
+
+  /**
+     Release all allocations. If more than one block was used they are
+     replaced by a single block of their total size.
+   */
+  void reset() {
+    if (blocks.size() > 1) {
+      size_t total = 0;
+      for (const auto &b : blocks)
+        total += b.second;
+      blocks.clear();
+      addBlock(total);
+    }
+    offset = 0;
+  }
+
+  /**
+     Total size of the blocks held.
+   */
+  size_t capacity() const {
+    size_t total = 0;
+    for (const auto &b : blocks)
+      total += b.second;
+    return total;
+  }
+};
+
+} // namespace Arena
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "memory.hpp"
+
+/**
+   Buckets of vertices indexed by height, as used by push-relabel. Each vertex
+   is in at most one bucket at a time, so buckets are linked lists threaded
+   through arrays indexed by vertex.
+ */
+namespace BucketQueue {
+
+/**
+   First-in-first-out buckets of vertices of type 'V', used to find the next
+   active vertex. A bitmap of non-empty buckets makes skipping empty ones
+   cheap. Storage only grows, such that it is reused by all computations on
+   the same graph. Buckets must be left empty after use.
+ */
+template <typename V> class Buckets {
+private:
+  /**
+     Vertex after each vertex in its bucket, undefined for the last vertex.
+   */
+  std::vector<V> next;
+
+  /**
+     First and last vertex of each bucket, -1 if empty.
+   */
+  std::vector<V> head, tail;
+
+  /**
+     Bit 'i' of word 'i / 64' is set if bucket 'i' is non-empty.
+   */
+  std::vector<uint64_t> nonEmpty;
+
+public:
+  /**
+     Make room for vertices '0,...,n-1' in buckets '0,...,count-1'.
+
+     Time complexity: O(1) unless storage grows.
+   */
+  void reserve(size_t n, size_t count) {
+    if (next.size() < n)
+      next.resize(n);
+    if (head.size() < count) {
+      head.resize(count, -1);
+      tail.resize(count, -1);
+      nonEmpty.resize((count + 63) / 64, 0);
+    }
+  }
+
+  bool empty(size_t b) const { return head[b] == -1; }
+
+  V front(size_t b) const {
+    assert(!empty(b) && "Front of empty bucket.");
+    return head[b];
+  }
+
+  /**
+     Append 'u' to bucket 'b'. 'u' must not be in any bucket.
+   */
+  void push(size_t b, V u) {
+    if (empty(b))
+      head[b] = u, nonEmpty[b / 64] |= uint64_t(1) << (b % 64);
+    else
+      next[tail[b]] = u;
+    tail[b] = u;
+  }
+
+  /**
+     Remove the first vertex of bucket 'b'.
+   */
+  void pop(size_t b) {
+    assert(!empty(b) && "Pop from empty bucket.");
+    if (head[b] == tail[b])
+      head[b] = tail[b] = -1, nonEmpty[b / 64] &= ~(uint64_t(1) << (b % 64));
+    else
+      head[b] = next[head[b]];
+  }
+
+  /**
+     Smallest non-empty bucket which is at least 'b', or the number of buckets
+     if there is none.
+
+     Time complexity: O(1 + (result - b) / 64)
+   */
+  size_t nextNonEmpty(size_t b) const {
+    size_t w = b / 64;
+    if (w >= nonEmpty.size())
+      return head.size();
+    uint64_t word = nonEmpty[w] & (~uint64_t(0) << (b % 64));
+    while (word == 0) {
+      if (++w == nonEmpty.size())
+        return head.size();
+      word = nonEmpty[w];
+    }
+    return w * 64 + size_t(__builtin_ctzll(word));
+  }
+
+  size_t bytes() const {
+    return Memory::bytes(next) + Memory::bytes(head) + Memory::bytes(tail) +
+           Memory::bytes(nonEmpty);
+  }
+};
+
+/**
+   Buckets of vertices of type 'V' in no particular order, where any vertex can
+   be removed from its bucket. Used to find the vertices at each height.
+ */
+template <typename V> class Sets {
+private:
+  /**
+     Neighbors of each vertex in its bucket, -1 at either end.
+   */
+  std::vector<V> next, prev;
+
+  /**
+     Some vertex of each bucket, -1 if empty.
+   */
+  std::vector<V> head;
+
+public:
+  /**
+     Make room for vertices '0,...,n-1' in buckets '0,...,count-1'.
+   */
+  void reserve(size_t n, size_t count) {
+    if (next.size() < n)
+      next.resize(n), prev.resize(n);
+    if (head.size() < count)
+      head.resize(count, -1);
+  }
+
+  /**
+     Empty bucket 'b' without touching the vertices in it.
+   */
+  void clear(size_t b) { head[b] = -1; }
+
+  bool empty(size_t b) const { return head[b] == -1; }
+
+  V front(size_t b) const {
+    assert(!empty(b) && "Front of empty bucket.");
+    return head[b];
+  }
+
+  /**
+     Add 'u' to bucket 'b'. 'u' must not be in any bucket.
+   */
+  void insert(size_t b, V u) {
+    next[u] = head[b], prev[u] = -1;
+    if (head[b] != -1)
+      prev[head[b]] = u;
+    head[b] = u;
+  }
+
+  /**
+     Remove 'u' from bucket 'b', which it must be in.
+   */
+  void erase(size_t b, V u) {
+    if (prev[u] == -1)
+      head[b] = next[u];
+    else
+      next[prev[u]] = next[u];
+    if (next[u] != -1)
+      prev[next[u]] = prev[u];
+  }
+
+  size_t bytes() const {
+    return Memory::bytes(next) + Memory::bytes(prev) + Memory::bytes(head);
+  }
+};
+
+} // namespace BucketQueue
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+/**
+   Storage of large arrays on transparent huge pages. Push-relabel reads the
+   height and edges of random vertices, and with 4KB pages most such reads
+   miss the TLB once arrays are larger than a few megabytes. A 2MB page covers
+   512 times as much memory per TLB entry.
+ */
+namespace HugePages {
+
+/**
+   Size of a huge page. Allocations of at least this size are aligned to it
+   and advised to be backed by huge pages.
+ */
+constexpr size_t pageSize = size_t(2) << 20;
+
+/**
+   Set to false to allocate large arrays like any other. Only affects arrays
+   allocated afterwards.
+ */
+inline bool enabled = true;
+
+/**
+   Allocate 'bytes' bytes. Large allocations are aligned to a huge page and
+   advised to use huge pages. If transparent huge pages are disabled the
+   advice is ignored and regular pages are used.
+ */
+inline void *allocate(size_t bytes) {
+  void *p = nullptr;
+  if (enabled && bytes >= pageSize) {
+    if (posix_memalign(&p, pageSize, bytes) != 0)
+      throw std::bad_alloc();
+#if defined(MADV_HUGEPAGE)
+    madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+    return p;
+  }
+
+  p = std::malloc(bytes == 0 ? 1 : bytes);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+inline void deallocate(void *p) { std::free(p); }
+
+/**
+   Allocator placing large arrays on huge pages, see 'allocate'.
+ */
+template <typename T> struct Allocator {
+  using value_type = T;
+
+  Allocator() = default;
+  template <typename U> Allocator(const Allocator<U> &) {}
+
+  T *allocate(size_t n) {
+    return static_cast<T *>(HugePages::allocate(n * sizeof(T)));
+  }
+  void deallocate(T *p, size_t) { HugePages::deallocate(p); }
+
+  friend bool operator==(const Allocator &, const Allocator &) {
+    return true;
+  }
+  friend bool operator!=(const Allocator &, const Allocator &) {
+    return false;
+  }
+};
+
+/**
+   Vector whose storage is placed on huge pages once it is large.
+ */
+template <typename T> using Vector = std::vector<T, Allocator<T>>;
+
+} // namespace HugePages
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+#include <vector>
+
+#include "memory.hpp"
+
+/**
+   Level cuts of a push-relabel flow, see Saranurak and Wang A.1. Vertices are
+   grouped by height and the cut between two consecutive levels with the
+   lowest conductance is chosen.
+ */
+namespace LevelCut {
+
+/**
+   Vertices of type 'V' grouped by level, with the volume and number of edges
+   going down to the level below of each level. Storage is kept between cuts.
+ */
+template <typename V, typename Volume> class Levels {
+private:
+  /**
+     Vertices in the order they were added and their levels.
+   */
+  std::vector<std::pair<int, V>> added;
+
+  /**
+     Vertices sorted by level, keeping the order they were added within a
+     level. Level 'i' is 'order[start[i]],...,order[start[i+1]-1]'.
+   */
+  std::vector<V> order;
+  std::vector<size_t> start, next;
+
+  /**
+     Volume and number of edges to the level below of each level.
+   */
+  std::vector<Volume> volume, down;
+
+public:
+  /**
+     Remove all vertices and use levels '0,...,maxLevel'.
+
+     Time complexity: O(maxLevel)
+   */
+  void clear(int maxLevel) {
+    added.clear();
+    start.assign(size_t(maxLevel) + 2, 0);
+    volume.assign(size_t(maxLevel) + 1, 0);
+    down.assign(size_t(maxLevel) + 1, 0);
+  }
+
+  /**
+     Add vertex 'u' with volume 'vol' and 'z' edges to the level below.
+   */
+  void add(int level, V u, Volume vol, Volume z) {
+    assert(level >= 0 && size_t(level) < volume.size() &&
+           "Level out of bounds.");
+    added.emplace_back(level, u);
+    start[level + 1]++;
+    volume[level] += vol;
+    down[level] += z;
+  }
+
+  /**
+     Cut the vertices added, with 'totalVolume' the volume of the graph. The
+     levels above the cut are scanned from the top, taking the level with the
+     lowest conductance, or the top level if none has conductance below one.
+     Return the vertices at or above the chosen level, from the top level
+     down, and the vertices below it, from level 0 up.
+
+     Time complexity: O(maxLevel + number of vertices)
+   */
+  std::pair<std::vector<V>, std::vector<V>> cut(Volume totalVolume) {
+    const int maxLevel = int(volume.size()) - 1;
+    for (int level = 0; level <= maxLevel; ++level)
+      start[level + 1] += start[level];
+    order.resize(added.size());
+    next.assign(start.begin(), start.end() - 1);
+    for (const auto &[level, u] : added)
+      order[next[level]++] = u;
+
+    Volume above = 0;
+    double bestConductance = 1.0;
+    int bestLevel = maxLevel;
+    for (int level = maxLevel; level > 0; --level) {
+      above += volume[level];
+      double conductance = double(down[level]) /
+                           double(std::min(above, totalVolume - above));
+      if (conductance < bestConductance)
+        bestConductance = conductance, bestLevel = level;
+    }
+
+    std::vector<V> left, right(order.begin(), order.begin() + start[bestLevel]);
+    left.reserve(order.size() - right.size());
+    for (int level = maxLevel; level >= bestLevel; --level)
+      left.insert(left.end(), order.begin() + start[level],
+                  order.begin() + start[level + 1]);
+
+    return std::make_pair(left, right);
+  }
+
+  size_t bytes() const {
+    return Memory::bytes(added) + Memory::bytes(order) + Memory::bytes(start) +
+           Memory::bytes(next) + Memory::bytes(volume) + Memory::bytes(down);
+  }
+};
+
+} // namespace LevelCut
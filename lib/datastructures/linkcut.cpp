@@ -7,11 +7,20 @@
 
 namespace LinkCut {
 
-Forest::Forest(int n) : vertices(n, SplayTree::Vertex(-1)) {
-  for (int i = 0; i < n; ++i)
+Forest::Forest(Vertex n) { assign(n); }
+
+void Forest::assign(Vertex n) {
+  vertices.assign(n, SplayTree::Vertex(-1));
+  for (Vertex i = 0; i < n; ++i)
     vertices[i].id = i;
 }
 
+Memory::Usage Forest::memoryUsage() const {
+  Memory::Usage usage;
+  usage.add("vertices", Memory::bytes(vertices));
+  return usage;
+}
+
 void Forest::access(Vertex vertex) {
   SplayTree::Vertex *u = &vertices[vertex];
   u->splay();
@@ -3,6 +3,7 @@
 #include <ostream>
 #include <vector>
 
+#include "memory.hpp"
 #include "splay_tree.hpp"
 
 /**
@@ -17,7 +18,7 @@
 
 namespace LinkCut {
 
-using Vertex = int;
+using Vertex = long long;
 
 class Forest {
 private:
@@ -34,7 +35,12 @@ public:
   /**
      Construct a forest with 'n' nodes.
    */
-  Forest(int n);
+  Forest(Vertex n);
+
+  /**
+     Replace the forest by 'n' disconnected nodes, reusing storage.
+   */
+  void assign(Vertex n);
 
   /**
      Return the weight of a vertex.
@@ -112,6 +118,11 @@ public:
       vertices[*it].reset();
   }
 
+  /**
+     Bytes allocated by the forest.
+   */
+  Memory::Usage memoryUsage() const;
+
   /**
      Print available information to the output stream without modifying the
      datastructure.
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <stack>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Memory {
+
+/**
+   Bytes allocated by each named component of a data structure. Components of
+   nested data structures are named with the name of the nested data structure
+   as prefix, e.g. 'flowGraph.edges'.
+ */
+class Usage {
+private:
+  std::vector<std::pair<std::string, size_t>> components;
+
+public:
+  /**
+     Add a component using 'bytes' bytes.
+   */
+  void add(const std::string &name, size_t bytes) {
+    components.emplace_back(name, bytes);
+  }
+
+  /**
+     Add the components of a nested data structure.
+   */
+  void add(const std::string &name, const Usage &nested) {
+    for (const auto &[component, bytes] : nested.components)
+      components.emplace_back(name + "." + component, bytes);
+  }
+
+  const std::vector<std::pair<std::string, size_t>> &getComponents() const {
+    return components;
+  }
+
+  /**
+     Total bytes of all components.
+   */
+  size_t total() const {
+    size_t result = 0;
+    for (const auto &c : components)
+      result += c.second;
+    return result;
+  }
+
+  /**
+     Write one line per component followed by the total.
+   */
+  friend std::ostream &operator<<(std::ostream &os, const Usage &usage) {
+    for (const auto &[component, bytes] : usage.components)
+      os << component << ": " << bytes << "\n";
+    return os << "total: " << usage.total() << "\n";
+  }
+};
+
+/**
+   Bytes allocated by a container, excluding the container object itself.
+   Stacks are counted by their elements, ignoring partly filled blocks.
+ */
+template <typename T, typename A> size_t bytes(const std::vector<T, A> &xs) {
+  return xs.capacity() * sizeof(T);
+}
+
+template <typename T> size_t bytes(const std::vector<std::vector<T>> &xss) {
+  size_t result = xss.capacity() * sizeof(std::vector<T>);
+  for (const auto &xs : xss)
+    result += bytes(xs);
+  return result;
+}
+
+template <typename T> size_t bytes(const std::stack<T> &xs) {
+  return xs.size() * sizeof(T);
+}
+
+} // namespace Memory
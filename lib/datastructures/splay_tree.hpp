@@ -5,8 +5,11 @@
 namespace SplayTree {
 class Vertex {
 public:
-  /** Unique identifier. */
-  int id;
+  /**
+     Unique identifier. 64-bit such that forests over large graphs are
+     supported, which does not grow the vertex because of pointer alignment.
+   */
+  long long id;
   /** Left and right nodes in the represented tree. */
   Vertex *left, *right;
   /** Parent in the auxillary tree. */
@@ -29,11 +32,11 @@ Path parent. This is the parent in the represented tree of the left-most
    */
   int deltaMin;
 
-  Vertex(int id, Vertex *left, Vertex *right, Vertex *parent,
+  Vertex(long long id, Vertex *left, Vertex *right, Vertex *parent,
          Vertex *pathparent, int deltaW, int deltaMin)
       : id(id), left(left), right(right), parent(parent),
         pathparent(pathparent), deltaW(deltaW), deltaMin(deltaMin) {}
-  Vertex(int id) : Vertex(id, nullptr, nullptr, nullptr, nullptr, 0, 0) {}
+  Vertex(long long id) : Vertex(id, nullptr, nullptr, nullptr, nullptr, 0, 0) {}
 
   /**
      Rotate current vertex upwards. Let 'u' be the current vertex, 'p' the
@@ -0,0 +1,273 @@
+#include <numeric>
+#include <queue>
+
+#include "subdivision_flow.hpp"
+
+namespace SubdivisionFlow {
+
+template <typename V, typename F>
+void BasicGraph<V, F>::assign(const Undirected::BasicGraph<V> &g) {
+  n = g.size();
+  endpoint.clear();
+  for (auto u = g.cbegin(); u != g.cend(); ++u)
+    for (auto e = g.cbeginEdge(*u); e != g.cendEdge(*u); ++e)
+      if (e->from < e->to)
+        endpoint.push_back(e->from), endpoint.push_back(e->to);
+  const V m = V(endpoint.size() / 2);
+
+  // Arms are listed by increasing index, as the edges of a materialised
+  // subdivision graph.
+  offsets.assign(size_t(n) + 1, 0);
+  for (const V u : endpoint)
+    offsets[u + 1]++;
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  arms.resize(endpoint.size());
+  armIdx.resize(endpoint.size());
+  std::vector<V> next(n, 0);
+  for (Arm a = 0; a < Arm(endpoint.size()); ++a) {
+    const V u = endpoint[a];
+    armIdx[a] = next[u]++;
+    arms[offsets[u] + size_t(armIdx[a])] = a;
+  }
+
+  swapped.assign(m, 0);
+  flow.assign(endpoint.size(), 0);
+  congestionIn.assign(endpoint.size(), 0);
+  congestionOut.assign(endpoint.size(), 0);
+  capacity = 0;
+
+  const V size = n + m;
+  vertices.resize(size);
+  vertexIndices.resize(size);
+  std::iota(vertices.begin(), vertices.end(), 0);
+  std::iota(vertexIndices.begin(), vertexIndices.end(), 0);
+  while (!vertexBound.empty())
+    vertexBound.pop();
+  vertexBound.push({size});
+  visited.assign(size, 0);
+
+  edgeBounds.clear();
+  for (V u = 0; u < size; ++u)
+    edgeBounds.emplace_back(globalDegree(u));
+  savedEdgeBounds.clear();
+  while (!volumes.empty())
+    volumes.pop();
+  volumes.push(SubsetGraph::Volumes(2 * Volume(endpoint.size()),
+                                    2 * Volume(endpoint.size())));
+
+  absorbed.assign(size, 0);
+  sink.assign(size, 0);
+  height.assign(size, 0);
+  nextEdgeIdx.assign(size, 0);
+  touched.clear();
+  isTouched.assign(size, 0);
+}
+
+template <typename V, typename F>
+Memory::Usage BasicGraph<V, F>::memoryUsage() const {
+  Memory::Usage usage;
+  usage.add("endpoint", Memory::bytes(endpoint));
+  usage.add("offsets", Memory::bytes(offsets));
+  usage.add("arms", Memory::bytes(arms));
+  usage.add("armIdx", Memory::bytes(armIdx));
+  usage.add("swapped", Memory::bytes(swapped));
+  usage.add("flow", Memory::bytes(flow));
+  usage.add("congestionIn", Memory::bytes(congestionIn));
+  usage.add("congestionOut", Memory::bytes(congestionOut));
+  usage.add("edgeBounds", Memory::bytes(edgeBounds));
+  usage.add("savedEdgeBounds", Memory::bytes(savedEdgeBounds));
+  usage.add("vertices", Memory::bytes(vertices));
+  usage.add("vertexBound", Memory::bytes(vertexBound));
+  usage.add("volumes", Memory::bytes(volumes));
+  usage.add("vertexIndices", Memory::bytes(vertexIndices));
+  usage.add("visited", Memory::bytes(visited));
+  usage.add("absorbed", Memory::bytes(absorbed));
+  usage.add("sink", Memory::bytes(sink));
+  usage.add("height", Memory::bytes(height));
+  usage.add("nextEdgeIdx", Memory::bytes(nextEdgeIdx));
+  usage.add("buckets", buckets.bytes());
+  usage.add("levels", levels.bytes());
+  usage.add("touched", Memory::bytes(touched));
+  usage.add("isTouched", Memory::bytes(isTouched));
+  return usage;
+}
+
+template <typename V, typename F> void BasicGraph<V, F>::remove(V u) {
+  {
+    const V fromIdx = vertexIndices[u], toIdx = --vertexBound.top().middle;
+    std::swap(vertices[fromIdx], vertices[toIdx]);
+    vertexIndices[u] = toIdx, vertexIndices[vertices[fromIdx]] = fromIdx;
+  }
+
+  auto &vs = volumes.top();
+  vs.alive -= 2 * Volume(degree(u));
+  vs.globalAlive -= globalDegree(u), vs.globalRemoved += globalDegree(u);
+
+  for (V i = 0; i < degree(u); ++i) {
+    const Arm a = arm(u, i);
+    const V v = to(u, a);
+    swapEdges(v, reverseIdx(u, a), --edgeBounds[v].middle);
+  }
+
+  edgeBounds[u].middle = 0;
+}
+
+template <typename V, typename F> void BasicGraph<V, F>::restoreRemoves() {
+  vertexBound.top().middle = vertexBound.top().end;
+  auto &vs = volumes.top();
+  vs.alive = vs.total;
+  vs.globalAlive += vs.globalRemoved, vs.globalRemoved = 0;
+  for (auto it = cbegin(); it != cend(); ++it)
+    edgeBounds[*it].middle = edgeBounds[*it].end;
+}
+
+template <typename V, typename F> void BasicGraph<V, F>::restoreSubgraph() {
+  const size_t levelBegin = savedEdgeBounds.size() - vertexBound.top().end;
+  for (size_t i = levelBegin; i < savedEdgeBounds.size(); ++i)
+    edgeBounds[savedEdgeBounds[i].first] = savedEdgeBounds[i].second;
+  savedEdgeBounds.erase(savedEdgeBounds.begin() + levelBegin,
+                        savedEdgeBounds.end());
+  vertexBound.pop();
+  volumes.pop();
+  assert(!vertexBound.empty() &&
+         "The top most vertex bound is required to represent entire graph.");
+}
+
+template <typename V, typename F> void BasicGraph<V, F>::resetCongestion() {
+  for (auto u : *this)
+    if (u < n)
+      for (V i = 0; i < degree(u); ++i) {
+        const Arm a = arm(u, i);
+        congestionIn[a] = 0, congestionOut[a] = 0;
+      }
+}
+
+template <typename V, typename F> Flow BasicGraph<V, F>::congestion() const {
+  Flow result = 0;
+  for (auto u : *this)
+    if (u < n)
+      for (V i = 0; i < degree(u); ++i) {
+        const Arm a = arm(u, i);
+        result = std::max({result, congestionIn[a], congestionOut[a]});
+      }
+  return result;
+}
+
+template <typename V, typename F>
+std::vector<V> BasicGraph<V, F>::compute(const int maxHeight) {
+  const int maxH = int(std::min<Volume>(maxHeight, Volume(size()) * 2 + 1));
+
+  // Buckets are empty after each call, since the loop below only ends once
+  // every bucket is.
+  buckets.reserve(absorbed.size(), size_t(maxH) + 1);
+
+  for (auto u : *this)
+    if (excess(u) > 0)
+      buckets.push(0, u);
+
+  int level = 0;
+  while (level <= maxH) {
+    if (buckets.empty(level)) {
+      level = int(buckets.nextNonEmpty(level));
+      continue;
+    }
+
+    const V u = buckets.front(level);
+    if (degree(u) == 0) {
+      buckets.pop(level);
+      continue;
+    }
+
+    assert(excess(u) > 0 &&
+           "Vertex popped from queue should have excess flow.");
+
+    const Arm a = arm(u, nextEdgeIdx[u]);
+    const V v = to(u, a);
+    const Flow residual = Flow(capacity) - Flow(flowFrom(u, a));
+
+    if (residual > 0 && height[u] == height[v] + 1) {
+      // Push flow across the arm.
+      assert(excess(v) == 0 && "Pushing to vertex with non-zero excess");
+      const Flow delta = std::min({excess(u), residual, Flow(degree(v))});
+
+      assert(isTouched[u] && "Vertex with excess should be touched.");
+      flow[a] += F(u < n ? delta : -delta);
+      absorbed[u] -= delta;
+      absorbed[v] += delta;
+      touch(v);
+
+      assert(excess(u) >= 0 && "Excess after pushing cannot be negative");
+      if (height[u] >= maxH || excess(u) == 0)
+        buckets.pop(level);
+
+      if (height[v] < maxH && excess(v) > 0) {
+        buckets.push(height[v], v);
+        level = std::min(level, int(height[v]));
+        nextEdgeIdx[v] = 0;
+      }
+    } else if (nextEdgeIdx[u] == degree(u) - 1) {
+      // all edges have been tried, relabel
+      buckets.pop(level);
+      height[u]++;
+      nextEdgeIdx[u] = 0;
+
+      if (height[u] < maxH)
+        buckets.push(height[u], u);
+    } else {
+      nextEdgeIdx[u]++;
+    }
+  }
+
+  // Only arms of touched split vertices have flow. Arms are in the subgraph
+  // if both their ends are.
+  for (auto u : touched)
+    if (u >= n && alive(u))
+      for (Arm a = 2 * Arm(u - n); a < 2 * Arm(u - n) + 2; ++a)
+        if (alive(endpoint[a])) {
+          if (flow[a] > 0)
+            congestionIn[a] += flow[a];
+          else
+            congestionOut[a] -= flow[a];
+        }
+
+  std::vector<V> hasExcess;
+  for (auto u : *this)
+    if (excess(u) > 0)
+      hasExcess.push_back(u);
+
+  return hasExcess;
+}
+
+template <typename V, typename F>
+std::pair<std::vector<V>, std::vector<V>>
+BasicGraph<V, F>::levelCut(const int h) {
+  levels.clear(h);
+  for (auto u : *this) {
+    Volume z = 0;
+    if (height[u] > 0)
+      for (V i = 0; i < degree(u); ++i)
+        if (height[u] == height[to(u, arm(u, i))] + 1)
+          z++;
+    levels.add(height[u], u, degree(u), z);
+  }
+
+  return levels.cut(this->volume());
+}
+
+template <typename V, typename F> void BasicGraph<V, F>::reset() {
+  for (auto u : touched) {
+    if (u >= n)
+      flow[2 * Arm(u - n)] = 0, flow[2 * Arm(u - n) + 1] = 0;
+    absorbed[u] = 0;
+    sink[u] = 0;
+    height[u] = 0;
+    nextEdgeIdx[u] = 0;
+    isTouched[u] = 0;
+  }
+  touched.clear();
+}
+
+template class BasicGraph<int32_t>;
+template class BasicGraph<int64_t>;
+template class BasicGraph<int32_t, int64_t>;
+} // namespace SubdivisionFlow
@@ -0,0 +1,456 @@
+#pragma once
+
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stack>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "bucket_queue.hpp"
+#include "huge_pages.hpp"
+#include "level_cut.hpp"
+#include "subset_graph.hpp"
+#include "undirected_graph.hpp"
+#include "unit_flow.hpp"
+
+namespace SubdivisionFlow {
+
+using SubsetGraph::Volume;
+using UnitFlow::Flow;
+
+/**
+   Subdivision flow graph of an undirected graph 'G = (V,E)' which is derived
+   from 'G' rather than materialised. Vertex 'u < |V|' is a vertex of 'G' and
+   vertex '|V| + i' is the split vertex of the i'th edge of 'G'. The edge
+   between a split vertex and one of the two endpoints of its edge is called an
+   arm. Arms '2i' and '2i+1' belong to split vertex '|V| + i'.
+
+   Only the order of adjacency lists and the flow and congestion of each arm
+   are stored, and all edges share the same capacity. Vertices and adjacency
+   lists are ordered exactly as in a 'UnitFlow::Graph' of the subdivision graph
+   undergoing the same operations.
+
+   Supports the subgraph operations of 'SubsetGraph::Graph' and the flow
+   operations of 'UnitFlow::Graph' used by the cut-matching game. 'V' must be
+   able to index the '|V| + |E|' vertices. 'F' is the integer type of the flow
+   across each arm. The topology, flow and congestion of arms are kept in
+   separate arrays, such that push-relabel only reads the arrays it needs.
+ */
+template <typename V, typename F = int32_t> class BasicGraph {
+public:
+  using Vertex = V;
+
+  /**
+     Index of an arm. Unsigned since there are twice as many arms as split
+     vertices.
+   */
+  using Arm = std::make_unsigned_t<V>;
+
+private:
+  /**
+     Number of vertices in 'G'.
+   */
+  V n;
+
+  /**
+     Vertex of 'G' at the end of each arm.
+   */
+  HugePages::Vector<V> endpoint;
+
+  /**
+     Adjacency lists of the vertices of 'G' as arms. The list of 'u' is
+     '[offsets[u],offsets[u+1])'.
+   */
+  HugePages::Vector<size_t> offsets;
+  HugePages::Vector<Arm> arms;
+
+  /**
+     Index of each arm in the adjacency list of its endpoint.
+   */
+  HugePages::Vector<V> armIdx;
+
+  /**
+     True if the adjacency list of a split vertex has its second arm first.
+   */
+  HugePages::Vector<char> swapped;
+
+  /**
+     Flow across each arm from its endpoint to its split vertex. Flow in the
+     other direction is negative.
+   */
+  HugePages::Vector<F> flow;
+
+  /**
+     Total flow which has crossed each arm towards and away from its split
+     vertex.
+   */
+  HugePages::Vector<Flow> congestionIn, congestionOut;
+
+  /**
+     Capacity of every edge.
+   */
+  F capacity;
+
+  /**
+     Number of edges alive in the adjacency list of each vertex, see
+     'SubsetGraph::Graph'.
+   */
+  HugePages::Vector<SubsetGraph::Bound<V>> edgeBounds;
+  std::vector<std::pair<V, SubsetGraph::Bound<V>>> savedEdgeBounds;
+
+  HugePages::Vector<V> vertices;
+  std::stack<SubsetGraph::Bound<V>> vertexBound;
+  std::stack<SubsetGraph::Volumes> volumes;
+  HugePages::Vector<V> vertexIndices;
+  HugePages::Vector<V> visited;
+
+  /**
+     Flow absorbed by, sink capacity, height and next edge to consider of each
+     vertex, see 'UnitFlow::Graph'.
+   */
+  HugePages::Vector<Flow> absorbed, sink;
+  HugePages::Vector<V> height, nextEdgeIdx;
+
+  /**
+     Vertices whose flow state may be non-zero since the last 'reset', and
+     whether each vertex is in 'touched'. Every vertex with source, sink,
+     height or edge cursor set is touched, and so is the split vertex of
+     every arm with flow, since a push changes the absorbed flow of both its
+     ends.
+   */
+  std::vector<V> touched;
+  HugePages::Vector<char> isTouched;
+
+  void touch(V u) {
+    if (!isTouched[u])
+      isTouched[u] = 1, touched.push_back(u);
+  }
+
+  /**
+     Buckets of 'compute' and levels of 'levelCut' kept between calls, see
+     'UnitFlow::Graph'.
+   */
+  BucketQueue::Buckets<V> buckets;
+  LevelCut::Levels<V, Volume> levels;
+
+  /**
+     The arm which is the i'th edge in the adjacency list of 'u'.
+   */
+  Arm arm(V u, V idx) const {
+    return u < n ? arms[offsets[u] + size_t(idx)]
+                 : 2 * Arm(u - n) + Arm(idx ^ swapped[u - n]);
+  }
+
+  /**
+     The vertex at the other end of arm 'a' as seen from 'u'.
+   */
+  V to(V u, Arm a) const { return u < n ? n + V(a / 2) : endpoint[a]; }
+
+  /**
+     Index of arm 'a' in the adjacency list of 'to(u,a)'.
+   */
+  V reverseIdx(V u, Arm a) const {
+    return u < n ? V((a & 1) ^ swapped[a / 2]) : armIdx[a];
+  }
+
+  /**
+     Flow across arm 'a' leaving 'u'.
+   */
+  Flow flowFrom(V u, Arm a) const {
+    return u < n ? Flow(flow[a]) : -Flow(flow[a]);
+  }
+
+  /**
+     Swap the i'th and j'th edge in the adjacency list of 'u'.
+   */
+  void swapEdges(V u, V i, V j) {
+    if (u < n) {
+      Arm *list = arms.data() + offsets[u];
+      std::swap(list[i], list[j]);
+      armIdx[list[i]] = i, armIdx[list[j]] = j;
+    } else if (i != j) {
+      swapped[u - n] ^= 1;
+    }
+  }
+
+public:
+  /**
+     Construct the subdivision flow graph of 'g' with zero capacity.
+   */
+  explicit BasicGraph(const Undirected::BasicGraph<V> &g) { assign(g); }
+
+  /**
+     Replace the graph by the subdivision flow graph of 'g'. Storage of the
+     previous graph is reused.
+   */
+  void assign(const Undirected::BasicGraph<V> &g);
+
+  typename HugePages::Vector<V>::const_iterator begin() const {
+    return vertices.cbegin();
+  }
+  typename HugePages::Vector<V>::const_iterator end() const {
+    return vertices.cbegin() + vertexBound.top().middle;
+  }
+  typename HugePages::Vector<V>::const_iterator cbegin() const {
+    return begin();
+  }
+  typename HugePages::Vector<V>::const_iterator cend() const { return end(); }
+  typename HugePages::Vector<V>::const_iterator cbeginRemoved() const {
+    return end();
+  }
+  typename HugePages::Vector<V>::const_iterator cendRemoved() const {
+    return vertices.cbegin() + vertexBound.top().end;
+  }
+
+  /**
+     Number of vertices in 'G'. Vertices with larger indices are split
+     vertices.
+   */
+  V originalSize() const { return n; }
+
+  /**
+     Number of vertices in subgraph.
+   */
+  V size() const { return vertexBound.top().middle; }
+
+  /**
+     Number of vertices removed in subgraph.
+   */
+  V removedSize() const {
+    return vertexBound.top().end - vertexBound.top().middle;
+  }
+
+  /**
+     True if vertex has not been removed.
+   */
+  bool alive(V u) const { return vertexIndices[u] < size(); }
+
+  V degree(V u) const { return edgeBounds[u].middle; }
+
+  V globalDegree(V u) const {
+    return u < n ? V(offsets[u + 1] - offsets[u]) : 2;
+  }
+
+  Volume edgeCount() const { return volume() / 2; }
+  Volume volume() const { return volumes.top().alive; }
+  Volume globalVolume() const { return volumes.top().globalAlive; }
+  Volume removedGlobalVolume() const { return volumes.top().globalRemoved; }
+
+  /**
+     Volume of given vertices in the entire graph.
+   */
+  template <typename It>
+  Volume globalVolume(It subsetBegin, It subsetEnd) const {
+    Volume total = 0;
+    for (auto it = subsetBegin; it != subsetEnd; ++it)
+      total += globalDegree(*it);
+    return total;
+  }
+
+  /**
+     Neighbors of vertex 'u' in adjacency list order.
+   */
+  std::vector<V> neighbors(V u) const {
+    std::vector<V> result;
+    for (V i = 0; i < degree(u); ++i)
+      result.push_back(to(u, arm(u, i)));
+    return result;
+  }
+
+  /**
+     Given a subset of vertices, return the same vertices where all of their
+     valid neighbors are included as well.
+
+     Time complexity: O(vol(subset))
+   */
+  template <typename It>
+  std::vector<V> subdivisionVertices(It subsetBegin, It subsetEnd) {
+    std::vector<V> result;
+    for (auto it = subsetBegin; it != subsetEnd; ++it) {
+      const V u = *it;
+      result.push_back(u);
+      for (V i = 0; i < degree(u); ++i) {
+        const V v = to(u, arm(u, i));
+        if (!visited[v])
+          result.push_back(v), visited[v] = true;
+      }
+    }
+
+    for (auto it = subsetBegin; it != subsetEnd; ++it)
+      for (V i = 0; i < degree(*it); ++i)
+        visited[to(*it, arm(*it, i))] = false;
+
+    return result;
+  }
+
+  /**
+     Remove a vertex from the current subgraph.
+
+     Time complexity: O(deg(u))
+   */
+  void remove(V u);
+
+  /**
+     Construct a new subgraph. The given vertices must be 'alive' or 'removed'
+     in the current subgraph.
+
+     Time complexity: O(|subset| + vol(subset))
+   */
+  template <typename It> void subgraph(It subsetBegin, It subsetEnd) {
+    vertexBound.push({0, V(std::distance(subsetBegin, subsetEnd))});
+
+    for (auto it = subsetBegin; it != subsetEnd; ++it) {
+      const V fromIdx = vertexIndices[*it], toIdx = vertexBound.top().middle++;
+      std::swap(vertices[fromIdx], vertices[toIdx]);
+      vertexIndices[vertices[fromIdx]] = fromIdx;
+      vertexIndices[vertices[toIdx]] = toIdx;
+    }
+
+    assert(vertexBound.top().middle == vertexBound.top().end &&
+           "Incorrect number of vertices added.");
+
+    for (auto it = begin(); it != end(); ++it)
+      visited[*it] = true;
+
+    Volume total = 0, globalTotal = 0;
+    for (auto it = begin(); it != end(); ++it) {
+      const V u = *it;
+      V offset = 0;
+      for (V fromIdx = 0; fromIdx < edgeBounds[u].end; ++fromIdx)
+        if (visited[to(u, arm(u, fromIdx))])
+          swapEdges(u, fromIdx, offset++);
+      savedEdgeBounds.emplace_back(u, edgeBounds[u]);
+      edgeBounds[u] = {offset};
+      total += offset, globalTotal += globalDegree(u);
+    }
+    volumes.push(SubsetGraph::Volumes(total, globalTotal));
+
+    for (auto it = begin(); it != end(); ++it)
+      visited[*it] = false;
+  }
+
+  /**
+     Restore all 'remove' operations in current subgraph.
+   */
+  void restoreRemoves();
+
+  /**
+     Restore to the previous, strictly larger, subgraph.
+   */
+  void restoreSubgraph();
+
+  /**
+     Set the capacity of every edge. Capacities beyond the range of 'F' are
+     clamped. This does not change the flow as long as the range of 'F'
+     exceeds the total source capacity.
+   */
+  void setCapacity(Flow c) {
+    capacity = F(std::min(c, Flow(std::numeric_limits<F>::max())));
+  }
+
+  /**
+     Set the congestion of every edge in the subgraph to 0.
+   */
+  void resetCongestion();
+
+  /**
+     Largest congestion of an edge in the subgraph, or 0 if there are no edges.
+   */
+  Flow congestion() const;
+
+  void addSource(V u, Flow amount) { absorbed[u] += amount, touch(u); }
+  void addSink(V u, Flow amount) { sink[u] += amount, touch(u); }
+
+  /**
+     Return the excess of a node, i.e. the flow it cannot absorb.
+   */
+  Flow excess(V u) const { return std::max((Flow)0, absorbed[u] - sink[u]); }
+
+  /**
+     Compute max flow with push relabel and max height h, see
+     'UnitFlow::Graph::compute'.
+   */
+  std::vector<V> compute(const int maxHeight);
+
+  /**
+     Compute a level cut, see 'UnitFlow::Graph::levelCut'.
+   */
+  std::pair<std::vector<V>, std::vector<V>> levelCut(const int maxHeight);
+
+  /**
+     Set all flow, sinks and source capacities to 0.
+
+     Time complexity: O(vertices touched since the last reset)
+   */
+  void reset();
+
+  /**
+     Bytes allocated by the graph.
+   */
+  Memory::Usage memoryUsage() const;
+
+  /**
+     Compute a matching between vertices using the current flow, searching
+     with depth first search from each source in the given range. See
+     'UnitFlow::Graph::matching'.
+   */
+  template <typename It>
+  std::vector<std::pair<V, V>> matching(It sourcesBegin, It sourcesEnd) {
+    std::vector<std::pair<V, V>> matches;
+
+    // The path of the current search, reused between searches.
+    std::vector<std::pair<V, Arm>> path;
+    V start;
+    std::function<V(V)> dfs = [&](V u) -> V {
+      visited[u] = start + 1;
+
+      if (absorbed[u] > 0 && sink[u] > 0) {
+        absorbed[u]--, sink[u]--;
+        return u;
+      }
+
+      for (V i = 0; i < degree(u); ++i) {
+        const Arm a = arm(u, i);
+        const V v = to(u, a);
+        if (flowFrom(u, a) <= 0 || visited[v] == start + 1)
+          continue;
+
+        path.push_back({u, a});
+        V m = dfs(v);
+        if (m != -1)
+          return m;
+        path.pop_back();
+      }
+
+      return -1;
+    };
+
+    for (auto it = sourcesBegin; it != sourcesEnd; ++it) {
+      start = *it;
+      path.clear();
+      V m = dfs(start);
+      if (m == -1)
+        continue;
+
+      // Matched paths use up one unit of flow in their direction.
+      for (auto [u, a] : path)
+        flow[a] += u < n ? -1 : 1;
+      matches.push_back({start, m});
+    }
+
+    for (auto it = cbegin(); it != cend(); ++it)
+      visited[*it] = false;
+
+    return matches;
+  }
+};
+
+using Graph = BasicGraph<int>;
+
+extern template class BasicGraph<int32_t>;
+extern template class BasicGraph<int64_t>;
+extern template class BasicGraph<int32_t, int64_t>;
+} // namespace SubdivisionFlow
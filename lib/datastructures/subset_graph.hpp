@@ -1,21 +1,177 @@
 #pragma once
 
 #include <algorithm>
+#include <cassert>
 #include <iostream>
 #include <numeric>
 #include <queue>
 #include <stack>
 #include <vector>
 
+#include "huge_pages.hpp"
+#include "memory.hpp"
+
 namespace SubsetGraph {
 
 /**
    Used to represent the number of elements still 'alive' in a vector.
  */
-struct Bound {
-  int middle, end;
-  Bound(int middle, int end) : middle(middle), end(end) {}
-  Bound(int end) : Bound(end, end) {}
+template <typename V> struct Bound {
+  V middle, end;
+  Bound(V middle, V end) : middle(middle), end(end) {}
+  Bound(V end) : Bound(end, end) {}
+};
+
+/**
+   Type of volumes and edge counts. Always 64 bits, since the volume of a graph
+   can exceed the range of its vertex indices.
+ */
+using Volume = long long;
+
+/**
+   Running volume totals of a subgraph, maintained by the operations changing
+   it such that volumes are available in constant time.
+ */
+struct Volumes {
+  /**
+     Volume of the alive vertices, and of all vertices in the subgraph as if
+     no vertex was removed.
+   */
+  Volume alive, total;
+
+  /**
+     Global volume of the alive and of the removed vertices.
+   */
+  Volume globalAlive, globalRemoved;
+
+  Volumes(Volume total, Volume globalTotal)
+      : alive(total), total(total), globalAlive(globalTotal),
+        globalRemoved(0) {}
+};
+
+/**
+   Adjacency storage where each vertex has its own vector of edges. Edges of
+   different vertices are in separate heap blocks.
+ */
+template <typename V, typename E> class NestedAdjacency {
+private:
+  std::vector<std::vector<E>> edges;
+
+public:
+  /**
+     Replace the adjacency lists by those of 'n' vertices and edges 'es',
+     adding reverse edges and setting reverse indices.
+   */
+  void assign(V n, const std::vector<E> &es) {
+    edges.resize(n);
+    for (auto &list : edges)
+      list.clear();
+
+    for (auto e : es) {
+      auto re = e.reverse();
+      e.revIdx = V(edges[e.to].size());
+      re.revIdx = V(edges[e.from].size());
+
+      edges[e.from].push_back(e);
+      edges[e.to].push_back(re);
+    }
+  }
+
+  /**
+     Replace the adjacency lists by those of an adjacency array. Reverse
+     indices are left undefined.
+   */
+  template <typename O, typename N>
+  void assign(V n, const O *offsets, const N *neighbors) {
+    edges.resize(n);
+    for (V u = 0; u < n; ++u) {
+      edges[u].clear();
+      edges[u].reserve(size_t(offsets[u + 1] - offsets[u]));
+      for (auto i = offsets[u]; i < offsets[u + 1]; ++i)
+        edges[u].emplace_back(u, V(neighbors[i]));
+    }
+  }
+
+  E *begin(V u) { return edges[u].data(); }
+  const E *begin(V u) const { return edges[u].data(); }
+
+  /**
+     Number of edges in the adjacency list of 'u'.
+   */
+  V degree(V u) const { return V(edges[u].size()); }
+
+  size_t bytes() const { return Memory::bytes(edges); }
+};
+
+/**
+   Adjacency storage where all edges are kept in a single array, such that the
+   adjacency list of 'u' is '[offsets[u],offsets[u+1])'. Scanning the lists of
+   consecutive vertices reads consecutive memory.
+ */
+template <typename V, typename E> class FlatAdjacency {
+private:
+  HugePages::Vector<E> edges;
+
+  /**
+     Offsets into 'edges'. 64-bit, since the number of edge slots '2m' can
+     exceed the range of 'V'.
+   */
+  HugePages::Vector<size_t> offsets;
+
+public:
+  /**
+     Replace the adjacency lists by those of 'n' vertices and edges 'es',
+     adding reverse edges and setting reverse indices. Lists are in the same
+     order as in 'NestedAdjacency'.
+   */
+  void assign(V n, const std::vector<E> &es) {
+    offsets.assign(size_t(n) + 1, 0);
+    for (const auto &e : es)
+      offsets[e.from + 1]++, offsets[e.to + 1]++;
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    edges.clear();
+    if (es.empty())
+      return;
+    // Every slot is overwritten below, the first edge only serves as filler
+    // since edges need not be default constructible.
+    edges.resize(2 * es.size(), es.front());
+    std::vector<V> next(n, 0);
+    for (auto e : es) {
+      auto re = e.reverse();
+      e.revIdx = next[e.to];
+      re.revIdx = next[e.from];
+
+      edges[offsets[e.from] + next[e.from]++] = e;
+      edges[offsets[e.to] + next[e.to]++] = re;
+    }
+  }
+
+  /**
+     Replace the adjacency lists by those of an adjacency array. Reverse
+     indices are left undefined.
+   */
+  template <typename O, typename N>
+  void assign(V n, const O *offsets, const N *neighbors) {
+    this->offsets.assign(offsets, offsets + size_t(n) + 1);
+    edges.clear();
+    edges.reserve(size_t(offsets[n]));
+    for (V u = 0; u < n; ++u)
+      for (auto i = offsets[u]; i < offsets[u + 1]; ++i)
+        edges.emplace_back(u, V(neighbors[i]));
+  }
+
+  E *begin(V u) { return edges.data() + offsets[u]; }
+  const E *begin(V u) const { return edges.data() + offsets[u]; }
+
+  /**
+     Number of edges in the adjacency list of 'u'.
+   */
+  V degree(V u) const { return V(offsets[u + 1] - offsets[u]); }
+
+  size_t bytes() const {
+    return Memory::bytes(edges) + Memory::bytes(offsets);
+  }
 };
 
 /**
@@ -26,50 +182,68 @@ struct Bound {
    Notation: 'n' and 'm' are the number of vertices and edges respectively in
    the current induced subgraph.
 
+   'V' is the integer type of vertex and edge indices. A 32-bit type keeps
+   storage compact while a 64-bit type supports more than 2^31 vertices. 'A'
+   is the adjacency storage, either 'FlatAdjacency' or 'NestedAdjacency'.
+
    Operations:
    - remove(u): remove a vertex from the current subgraph.
    - subgraph(us): create a new subgraph induced by the vertices 'us'.
    - restoreRemoves(): restore all remove operations in current subgraph.
    - restoreSubgraph(): restore to the previous subgraph.
  */
-template <typename V, typename E> class Graph {
+template <typename V, typename E, typename A = FlatAdjacency<V, E>>
+class Graph {
 private:
   /**
      Adjacency list for each vertex.
    */
-  std::vector<std::vector<E>> edges;
+  A edges;
 
   /**
-     A stack of bounds associated with each vertex defining the number of edges
-     in their adjacency list which are 'alive'.
+     Bounds associated with each vertex defining the number of edges in their
+     adjacency list which are 'alive' in the current subgraph.
 
      Current active edges for vertex 'u' are described by:
-       '{edges[i] | i \in [0,edgeBounds[u].top().middle)}'
+       '{edges[i] | i \in [0,edgeBounds[u].middle)}'
+   */
+  HugePages::Vector<Bound<V>> edgeBounds;
+
+  /**
+     Arena of edge bounds belonging to enclosing subgraphs. Each call to
+     'subgraph' appends the previous bound of every vertex in the new subgraph,
+     and 'restoreSubgraph' writes them back and truncates the arena. Its size
+     is the total number of vertices in all subgraphs but the entire graph.
    */
-  std::vector<std::stack<Bound, std::vector<Bound>>> edgeBounds;
+  std::vector<std::pair<V, Bound<V>>> savedEdgeBounds;
 
   /**
      List of vertices in arbitrary order.
    */
-  std::vector<int> vertices;
+  HugePages::Vector<V> vertices;
 
   /**
      A stack of bounds describing the current vertices which are alive:
        '{vertices[i] | i \in [0,vertexBound.top().middle}'
    */
-  std::stack<Bound> vertexBound;
+  std::stack<Bound<V>> vertexBound;
+
+  /**
+     Volumes of the subgraphs in 'vertexBound'.
+   */
+  std::stack<Volumes> volumes;
 
   /**
      List of indices such that 'vertices[vertexIndices[u]] = u'
    */
-  std::vector<int> vertexIndices;
+  HugePages::Vector<V> vertexIndices;
 
 protected:
   /**
      Used to mark vertex as visited in search algorithms. Set values to 0 after
      use.
   */
-  std::vector<int> visited;
+  HugePages::Vector<V> visited;
 
 public:
   /**
@@ -78,23 +252,71 @@ public:
 
      Time complexity: O(n + m)
    */
-  Graph(int n, const std::vector<E> &es)
-      : edges(n), edgeBounds(n), vertices(n), vertexIndices(n), visited(n) {
+  Graph(V n, const std::vector<E> &es) { assign(n, es); }
+
+  /**
+     Construct a graph with 'n' vertices from an adjacency array. The neighbors
+     of 'u' are '{neighbors[i] | i \in [offsets[u],offsets[u+1])}'. Each edge
+     must be present in the adjacency list of both its endpoints and every
+     adjacency list must be sorted without duplicates or self-loops.
+
+     Time complexity: O(n + m)
+   */
+  template <typename O, typename N>
+  Graph(V n, const O *offsets, const N *neighbors)
+      : vertices(n), vertexIndices(n), visited(n) {
     std::iota(vertices.begin(), vertices.end(), 0);
     std::iota(vertexIndices.begin(), vertexIndices.end(), 0);
     vertexBound.push({n});
 
-    for (auto e : es) {
-      auto re = e.reverse();
-      e.revIdx = int(edges[e.to].size());
-      re.revIdx = int(edges[e.from].size());
-
-      edges[e.from].push_back(e);
-      edges[e.to].push_back(re);
+    edges.assign(n, offsets, neighbors);
+
+    // Since adjacency lists are sorted, the reverse of '(u,v)' with 'u < v' is
+    // the first entry in the list of 'v' which has not been paired yet.
+    std::vector<V> nextReverse(n, 0);
+    for (V u = 0; u < n; ++u) {
+      for (V i = 0; i < edges.degree(u); ++i) {
+        auto &e = edges.begin(u)[i];
+        if (u < e.to) {
+          const V j = nextReverse[e.to]++;
+          assert(edges.begin(e.to)[j].to == u &&
+                 "Adjacency array should be sorted and symmetric.");
+          e.revIdx = j, edges.begin(e.to)[j].revIdx = i;
+        }
+      }
     }
 
-    for (int u = 0; u < n; ++u)
-      edgeBounds[u].push({int(edges[u].size())});
+    edgeBounds.reserve(n);
+    for (V u = 0; u < n; ++u)
+      edgeBounds.emplace_back(edges.degree(u));
+    volumes.push(Volumes(Volume(offsets[n]), Volume(offsets[n])));
+  }
+
+  /**
+     Replace the graph by one with 'n' vertices and edges 'es'. Reverse edges
+     are added automatically. Adjacency lists and bounds of the previous graph
+     are cleared rather than freed, such that their storage is reused.
+
+     Time complexity: O(n + m)
+   */
+  void assign(V n, const std::vector<E> &es) {
+    vertices.resize(n);
+    vertexIndices.resize(n);
+    std::iota(vertices.begin(), vertices.end(), 0);
+    std::iota(vertexIndices.begin(), vertexIndices.end(), 0);
+    while (!vertexBound.empty())
+      vertexBound.pop();
+    vertexBound.push({n});
+    visited.assign(n, 0);
+
+    edges.assign(n, es);
+    edgeBounds.clear();
+    for (V u = 0; u < n; ++u)
+      edgeBounds.emplace_back(edges.degree(u));
+    savedEdgeBounds.clear();
+    while (!volumes.empty())
+      volumes.pop();
+    volumes.push(Volumes(2 * Volume(es.size()), 2 * Volume(es.size())));
   }
 
   /**
@@ -102,14 +324,14 @@ public:
 
      Time complexity: O(1)
    */
-  typename std::vector<V>::iterator begin() { return vertices.begin(); }
+  typename HugePages::Vector<V>::iterator begin() { return vertices.begin(); }
 
   /**
      Constant vertex begin-iterator.
 
      Time complexity: O(1)
    */
-  typename std::vector<V>::const_iterator cbegin() const {
+  typename HugePages::Vector<V>::const_iterator cbegin() const {
     return vertices.cbegin();
   }
 
@@ -118,7 +340,7 @@ public:
 
      Time complexity: O(1)
    */
-  typename std::vector<V>::iterator end() {
+  typename HugePages::Vector<V>::iterator end() {
     return vertices.begin() + vertexBound.top().middle;
   }
 
@@ -127,7 +349,7 @@ public:
 
      Time complexity: O(1)
    */
-  typename std::vector<V>::const_iterator cend() const {
+  typename HugePages::Vector<V>::const_iterator cend() const {
     return vertices.cbegin() + vertexBound.top().middle;
   }
 
@@ -136,7 +358,7 @@ public:
 
      Time complexity: O(1)
    */
-  typename std::vector<V>::iterator beginRemoved() {
+  typename HugePages::Vector<V>::iterator beginRemoved() {
     return vertices.begin() + vertexBound.top().middle;
   }
 
@@ -145,7 +367,7 @@ public:
 
      Time complexity: O(1)
    */
-  typename std::vector<V>::const_iterator cbeginRemoved() const {
+  typename HugePages::Vector<V>::const_iterator cbeginRemoved() const {
     return vertices.cbegin() + vertexBound.top().middle;
   }
 
@@ -154,7 +376,7 @@ public:
 
      Time complexity: O(1)
    */
-  typename std::vector<V>::iterator endRemoved() {
+  typename HugePages::Vector<V>::iterator endRemoved() {
     return vertices.begin() + vertexBound.top().end;
   }
 
@@ -163,7 +385,7 @@ public:
 
      Time complexity: O(1)
    */
-  typename std::vector<V>::const_iterator cendRemoved() const {
+  typename HugePages::Vector<V>::const_iterator cendRemoved() const {
     return vertices.cbegin() + vertexBound.top().end;
   }
 
@@ -172,55 +394,51 @@ public:
 
      Time complexity: O(1)
    */
-  typename std::vector<E>::iterator beginEdge(V u) { return edges[u].begin(); }
+  E *beginEdge(V u) { return edges.begin(u); }
 
   /**
      Constant edge begin-iterator.
 
      Time complexity: O(1)
    */
-  typename std::vector<E>::const_iterator cbeginEdge(V u) const {
-    return edges[u].cbegin();
-  }
+  const E *cbeginEdge(V u) const { return edges.begin(u); }
 
   /**
      Edge end-iterator.
 
      Time complexity: O(1)
    */
-  typename std::vector<E>::iterator endEdge(V u) {
-    return edges[u].begin() + edgeBounds[u].top().middle;
-  }
+  E *endEdge(V u) { return edges.begin(u) + edgeBounds[u].middle; }
 
   /**
      Constant edge end-iterator.
 
      Time complexity: O(1)
    */
-  typename std::vector<E>::const_iterator cendEdge(V u) const {
-    return edges[u].cbegin() + edgeBounds[u].top().middle;
+  const E *cendEdge(V u) const {
+    return edges.begin(u) + edgeBounds[u].middle;
   }
 
   /**
      Return the i'th edge in the adjacency list of vertex 'u'.
    */
-  E &getEdge(V u, int idx) {
+  E &getEdge(V u, V idx) {
     assert(idx >= 0 && "Edge index cannot be negative.");
     assert(
-        idx < edgeBounds[u].top().middle &&
+        idx < edgeBounds[u].middle &&
         "Edge index larger than number of edges in subgraph adjacency list.");
-    return edges[u][idx];
+    return edges.begin(u)[idx];
   }
 
   /**
      Return the i'th edge in the adjacency list of vertex 'u' as constant edge.
    */
-  const E &getEdge(V u, int idx) const {
+  const E &getEdge(V u, V idx) const {
     assert(idx >= 0 && "Edge index cannot be negative.");
     assert(
-        idx < edgeBounds[u].top().middle &&
+        idx < edgeBounds[u].middle &&
         "Edge index larger than number of edges in subgraph adjacency list.");
-    return edges[u][idx];
+    return edges.begin(u)[idx];
   }
 
   /**
@@ -228,7 +446,7 @@ public:
    */
   E &reverse(const E &e) {
     assert(e.revIdx != -1 && "Reverse index undefined.");
-    return edges[e.to][e.revIdx];
+    return edges.begin(e.to)[e.revIdx];
   }
 
   /**
@@ -236,7 +454,7 @@ public:
    */
   const E &reverse(const E &e) const {
     assert(e.revIdx != -1 && "Reverse index undefined.");
-    return edges[e.to][e.revIdx];
+    return edges.begin(e.to)[e.revIdx];
   }
 
   /**
@@ -261,7 +479,7 @@ public:
   std::vector<V> subdivisionVertices(It subsetBegin, It subsetEnd) {
     std::vector<V> result;
     for (auto it = subsetBegin; it != subsetEnd; ++it) {
-      const int u = *it;
+      const V u = *it;
       result.push_back(u);
       for (auto e = cbeginEdge(u); e != cendEdge(u); ++e)
         if (!visited[e->to])
@@ -280,12 +498,12 @@ public:
 
      Time complexity: O(1)
    */
-  int size() const { return vertexBound.top().middle; }
+  V size() const { return vertexBound.top().middle; }
 
   /**
      Number of vertices removed in subgraph.
    */
-  int removedSize() const {
+  V removedSize() const {
     return vertexBound.top().end - vertexBound.top().middle;
   }
 
@@ -294,66 +512,70 @@ public:
    */
   bool alive(V u) const { return vertexIndices[u] < size(); }
 
+  /**
+     Position of vertex 'u' when iterating over the subgraph, if alive.
+   */
+  V position(V u) const { return vertexIndices[u]; }
+
   /**
      Degree of vertex 'u'.
 
      Time complexity: O(1)
    */
-  int degree(V u) const { return edgeBounds[u].top().middle; }
+  V degree(V u) const { return edgeBounds[u].middle; }
 
   /**
      Degree of vertex 'u' in entire graph.
 
      Time complexity: O(1)
    */
-  int globalDegree(V u) const { return int(edges[u].size()); }
+  V globalDegree(V u) const { return edges.degree(u); }
 
   /**
      Number of edges in graph.
 
-     Time complexity: O(m)
+     Time complexity: O(1)
    */
-  int edgeCount() const { return volume() / 2; }
+  Volume edgeCount() const { return volume() / 2; }
 
   /**
      Volume of subgraph.
 
-     Time complexity: O(m)
+     Time complexity: O(1)
    */
-  int volume() const {
-    int total = 0;
-    for (auto it = cbegin(); it != cend(); ++it)
-      total += degree(*it);
-    return total;
-  }
+  Volume volume() const { return volumes.top().alive; }
 
   /**
      Volume of given vertices in the current subgraph.
    */
-  template <typename It> int volume(It subsetBegin, It subsetEnd) const {
-    int total = 0;
+  template <typename It> Volume volume(It subsetBegin, It subsetEnd) const {
+    Volume total = 0;
     for (auto it = subsetBegin; it != subsetEnd; ++it)
       total += degree(*it);
     return total;
   }
 
   /**
-     Volume of entire graph.
+     Volume of the vertices in the subgraph in the entire graph.
 
-     Time complexity: O(m)
+     Time complexity: O(1)
    */
-  int globalVolume() const {
-    int total = 0;
-    for (auto it = cbegin(); it != cend(); ++it)
-      total += globalDegree(*it);
-    return total;
-  }
+  Volume globalVolume() const { return volumes.top().globalAlive; }
+
+  /**
+     Volume of the vertices removed from the subgraph in the entire graph.
+     Equal to 'globalVolume(cbeginRemoved(), cendRemoved())'.
+
+     Time complexity: O(1)
+   */
+  Volume removedGlobalVolume() const { return volumes.top().globalRemoved; }
 
   /**
      Volume of given vertices in the entire graph.
    */
-  template <typename It> int globalVolume(It subsetBegin, It subsetEnd) const {
-    int total = 0;
+  template <typename It>
+  Volume globalVolume(It subsetBegin, It subsetEnd) const {
+    Volume total = 0;
     for (auto it = subsetBegin; it != subsetEnd; ++it)
       total += globalDegree(*it);
     return total;
@@ -404,20 +626,25 @@ public:
    */
   void remove(V u) {
     {
-      const int fromIdx = vertexIndices[u], toIdx = --vertexBound.top().middle;
+      const V fromIdx = vertexIndices[u], toIdx = --vertexBound.top().middle;
       std::swap(vertices[fromIdx], vertices[toIdx]);
       vertexIndices[u] = toIdx, vertexIndices[vertices[fromIdx]] = fromIdx;
     }
 
+    auto &vs = volumes.top();
+    vs.alive -= 2 * Volume(degree(u));
+    vs.globalAlive -= globalDegree(u), vs.globalRemoved += globalDegree(u);
+
     for (auto e = beginEdge(u); e != endEdge(u); ++e) {
       const V v = e->to;
-      const int fromIdx = e->revIdx, toIdx = --edgeBounds[v].top().middle;
-      std::swap(edges[v][fromIdx], edges[v][toIdx]);
-      reverse(edges[v][fromIdx]).revIdx = fromIdx;
-      reverse(edges[v][toIdx]).revIdx = toIdx;
+      const V fromIdx = e->revIdx, toIdx = --edgeBounds[v].middle;
+      E *list = edges.begin(v);
+      std::swap(list[fromIdx], list[toIdx]);
+      reverse(list[fromIdx]).revIdx = fromIdx;
+      reverse(list[toIdx]).revIdx = toIdx;
     }
 
-    edgeBounds[u].top().middle = 0;
+    edgeBounds[u].middle = 0;
   }
 
   /**
@@ -427,10 +654,10 @@ public:
      Time complexity: O(|subset| + vol(subset))
    */
   template <typename It> void subgraph(It subsetBegin, It subsetEnd) {
-    vertexBound.push({0, int(std::distance(subsetBegin, subsetEnd))});
+    vertexBound.push({0, V(std::distance(subsetBegin, subsetEnd))});
 
     for (auto it = subsetBegin; it != subsetEnd; ++it) {
-      const int fromIdx = vertexIndices[*it],
+      const V fromIdx = vertexIndices[*it],
                 toIdx = vertexBound.top().middle++;
       std::swap(vertices[fromIdx], vertices[toIdx]);
       vertexIndices[vertices[fromIdx]] = fromIdx;
@@ -443,20 +670,24 @@ public:
     for (auto it = begin(); it != end(); ++it)
       visited[*it] = true;
 
+    Volume total = 0, globalTotal = 0;
     for (auto it = begin(); it != end(); ++it) {
-      const int u = *it;
-      int offset = 0;
-      for (int fromIdx = 0; fromIdx < edgeBounds[u].top().end; ++fromIdx) {
-        const auto &e = edges[u][fromIdx];
-        if (visited[e.to]) {
-          const int toIdx = offset++;
-          std::swap(edges[u][fromIdx], edges[u][toIdx]);
-          reverse(edges[u][fromIdx]).revIdx = fromIdx;
-          reverse(edges[u][toIdx]).revIdx = toIdx;
+      const V u = *it;
+      E *list = edges.begin(u);
+      V offset = 0;
+      for (V fromIdx = 0; fromIdx < edgeBounds[u].end; ++fromIdx) {
+        if (visited[list[fromIdx].to]) {
+          const V toIdx = offset++;
+          std::swap(list[fromIdx], list[toIdx]);
+          reverse(list[fromIdx]).revIdx = fromIdx;
+          reverse(list[toIdx]).revIdx = toIdx;
         }
       }
-      edgeBounds[u].push({offset});
+      savedEdgeBounds.emplace_back(u, edgeBounds[u]);
+      edgeBounds[u] = {offset};
+      total += offset, globalTotal += globalDegree(u);
     }
+    volumes.push(Volumes(total, globalTotal));
 
     for (auto it = begin(); it != end(); ++it)
       visited[*it] = false;
@@ -469,8 +700,11 @@ public:
    */
   void restoreRemoves() {
     vertexBound.top().middle = vertexBound.top().end;
+    auto &vs = volumes.top();
+    vs.alive = vs.total;
+    vs.globalAlive += vs.globalRemoved, vs.globalRemoved = 0;
     for (auto it = cbegin(); it != cend(); ++it)
-      edgeBounds[*it].top().middle = edgeBounds[*it].top().end;
+      edgeBounds[*it].middle = edgeBounds[*it].end;
   }
 
   /**
@@ -479,21 +713,37 @@ public:
      Time complexity: O(n)
    */
   void restoreSubgraph() {
-    for (auto it = begin(); it != end(); ++it) {
-      const int u = *it;
-      edgeBounds[u].pop();
-      assert(!edgeBounds[u].empty() && "The top most edge bound is require to "
-                                       "represent an entire adjacency list.");
-    }
+    const size_t levelBegin = savedEdgeBounds.size() - vertexBound.top().end;
+    for (size_t i = levelBegin; i < savedEdgeBounds.size(); ++i)
+      edgeBounds[savedEdgeBounds[i].first] = savedEdgeBounds[i].second;
+    savedEdgeBounds.erase(savedEdgeBounds.begin() + levelBegin,
+                          savedEdgeBounds.end());
     vertexBound.pop();
+    volumes.pop();
     assert(!vertexBound.empty() &&
            "The top most vertex bound is required to represent entire graph.");
   }
 
+  /**
+     Bytes allocated by the graph.
+   */
+  Memory::Usage memoryUsage() const {
+    Memory::Usage usage;
+    usage.add("edges", edges.bytes());
+    usage.add("edgeBounds", Memory::bytes(edgeBounds));
+    usage.add("savedEdgeBounds", Memory::bytes(savedEdgeBounds));
+    usage.add("vertices", Memory::bytes(vertices));
+    usage.add("vertexBound", Memory::bytes(vertexBound));
+    usage.add("volumes", Memory::bytes(volumes));
+    usage.add("vertexIndices", Memory::bytes(vertexIndices));
+    usage.add("visited", Memory::bytes(visited));
+    return usage;
+  }
+
   /**
      Writes the adjacency list of every active vertex.
    */
-  friend std::ostream &operator<<(std::ostream &os, const Graph<V, E> &g) {
+  friend std::ostream &operator<<(std::ostream &os, const Graph &g) {
     for (auto it = g.cbegin(); it != g.cend(); ++it) {
       V u = *it;
       os << u << ":";
@@ -1,4 +1,3 @@
-
 #pragma once
 
 #include "subset_graph.hpp"
@@ -6,29 +5,30 @@
 namespace Undirected {
 
 /**
-   Undirected edge with index to reverse edge.
+   Undirected edge with index to reverse edge. 'V' is the integer type of
+   vertex indices.
  */
-struct Edge {
-  int from, to, revIdx;
+template <typename V> struct BasicEdge {
+  V from, to, revIdx;
 
   /**
      Construct an edge 'from->to'. 'revIdx' remains undefined.
    */
-  Edge(int from, int to) : from(from), to(to), revIdx(-1) {}
+  BasicEdge(V from, V to) : from(from), to(to), revIdx(-1) {}
 
   /**
      Construct the reverse of this edge. 'revIdx' remains undefined since it is
      maintained by the graph representation.
    */
-  Edge reverse() const {
-    Edge e{to, from};
+  BasicEdge reverse() const {
+    BasicEdge e{to, from};
     return e;
   }
 
   /**
      Two edges are equal if all their fields agree, including reverse index.
   */
-  friend bool operator==(const Edge &lhs, const Edge &rhs) {
+  friend bool operator==(const BasicEdge &lhs, const BasicEdge &rhs) {
     return lhs.from == rhs.from && lhs.to == rhs.to && lhs.revIdx == rhs.revIdx;
   }
 };
@@ -36,5 +36,8 @@ struct Edge {
 /**
    An undirected graph is represented by subset graph.
  */
-using Graph = SubsetGraph::Graph<int, Edge>;
+template <typename V> using BasicGraph = SubsetGraph::Graph<V, BasicEdge<V>>;
+
+using Edge = BasicEdge<int>;
+using Graph = BasicGraph<int>;
 } // namespace Undirected
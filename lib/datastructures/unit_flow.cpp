@@ -4,39 +4,85 @@
 
 namespace UnitFlow {
 
-Edge::Edge(Vertex from, Vertex to, Flow flow, Flow capacity, Flow congestion)
+template <typename V>
+BasicEdge<V>::BasicEdge(V from, V to, Flow flow, Flow capacity,
+                        Flow congestion)
     : from(from), to(to), revIdx(-1), flow(flow), capacity(capacity),
       congestion(congestion) {}
 
-Edge::Edge(Vertex from, Vertex to, Flow flow, Flow capacity)
-    : Edge(from, to, flow, capacity, 0) {}
+template <typename V>
+BasicEdge<V>::BasicEdge(V from, V to, Flow flow, Flow capacity)
+    : BasicEdge(from, to, flow, capacity, 0) {}
 
-Edge::Edge(Vertex from, Vertex to, Flow capacity)
-    : Edge(from, to, 0, capacity) {}
+template <typename V>
+BasicEdge<V>::BasicEdge(V from, V to, Flow capacity)
+    : BasicEdge(from, to, 0, capacity) {}
 
-Graph::Graph(int n, const std::vector<Edge> &es)
-    : SubsetGraph::Graph<int, Edge>(n, es), absorbed(n), sink(n), height(n),
+template <typename V>
+BasicEdge<V>::BasicEdge(V from, V to) : BasicEdge(from, to, 0) {}
+
+template <typename V, template <typename, typename> class A>
+BasicGraph<V, A>::BasicGraph(V n, const std::vector<Edge> &es)
+    : Base(n, es), absorbed(n), sink(n), outflow(n), height(n),
       nextEdgeIdx(n), forest(n) {}
 
-std::vector<Vertex> Graph::compute(const int maxHeight) {
-  const int maxH = std::min(maxHeight, size() * 2 + 1);
+template <typename V, template <typename, typename> class A>
+void BasicGraph<V, A>::assign(V n, const std::vector<Edge> &es) {
+  Base::assign(n, es);
+  absorbed.assign(n, 0);
+  sink.assign(n, 0);
+  outflow.assign(n, 0);
+  height.assign(n, 0);
+  nextEdgeIdx.assign(n, 0);
+  forest.assign(n);
+}
 
-  std::vector<std::queue<Vertex>> q(maxH + 1);
+template <typename V, template <typename, typename> class A>
+Memory::Usage BasicGraph<V, A>::memoryUsage() const {
+  Memory::Usage usage = Base::memoryUsage();
+  usage.add("absorbed", Memory::bytes(absorbed));
+  usage.add("sink", Memory::bytes(sink));
+  usage.add("outflow", Memory::bytes(outflow));
+  usage.add("height", Memory::bytes(height));
+  usage.add("nextEdgeIdx", Memory::bytes(nextEdgeIdx));
+  usage.add("buckets", buckets.bytes());
+  usage.add("levels", levels.bytes());
+  usage.add("atHeight", atHeight.bytes());
+  usage.add("distance", Memory::bytes(distance));
+  usage.add("relabelQueue", Memory::bytes(relabelQueue));
+  usage.add("forest", forest.memoryUsage());
+  return usage;
+}
 
-  for (auto u : *this)
-    if (excess(u) > 0)
-      q[0].push(u);
+template <typename V, template <typename, typename> class A>
+void BasicGraph<V, A>::pushRelabel(const int maxH, std::vector<V> &stuck,
+                                   Heuristics heuristics) {
+  // Upper bound on the heights with vertices in 'atHeight'.
+  int top = maxH - 1;
+  if (heuristics.gap)
+    fillHeights(maxH);
+  Volume relabels = 0;
 
   int level = 0;
   while (level <= maxH) {
-    if (q[level].empty()) {
-      level++;
+    if (buckets.empty(level)) {
+      level = int(buckets.nextNonEmpty(level));
       continue;
     }
 
-    const int u = q[level].front();
+    const V u = buckets.front(level);
     if (degree(u) == 0) {
-      q[level].pop();
+      buckets.pop(level);
+      stuck.push_back(u);
+      continue;
+    }
+
+    if (height[u] >= maxH) {
+      // Lifted while active, or left at or above the max height by a previous
+      // call. Such vertices never push, since a vertex below them may still
+      // be queued with excess.
+      buckets.pop(level);
+      stuck.push_back(u);
       continue;
     }
 
@@ -54,6 +100,13 @@ std::vector<Vertex> Graph::compute(const int maxHeight) {
       UnitFlow::Flow delta = std::min(
           {excess(e.from), e.residual(), (UnitFlow::Flow)degree(e.to)});
 
+      // The part of 'delta' cancelling flow from 'e.to' to 'e.from' reduces
+      // the flow leaving 'e.to' instead of adding to that leaving 'e.from'.
+      const UnitFlow::Flow cancelled =
+          std::min(delta, std::max((UnitFlow::Flow)0, -e.flow));
+      outflow[e.from] += delta - cancelled;
+      outflow[e.to] -= cancelled;
+
       e.flow += delta;
       reverse(e).flow -= delta;
 
@@ -61,33 +114,140 @@ std::vector<Vertex> Graph::compute(const int maxHeight) {
       absorbed[e.to] += delta;
 
       assert(excess(e.from) >= 0 && "Excess after pushing cannot be negative");
-      if (height[e.from] >= maxH || excess(e.from) == 0)
-        q[level].pop();
+      if (height[e.from] >= maxH || excess(e.from) == 0) {
+        buckets.pop(level);
+        if (excess(e.from) > 0)
+          stuck.push_back(e.from);
+      }
 
       if (height[e.to] < maxH && excess(e.to) > 0) {
-        q[height[e.to]].push(e.to);
-        level = std::min(level, height[e.to]);
+        buckets.push(height[e.to], e.to);
+        level = std::min(level, int(height[e.to]));
         nextEdgeIdx[e.to] = 0;
       }
     } else if (nextEdgeIdx[e.from] == degree(e.from) - 1) {
       // all edges have been tried, relabel
-      q[level].pop();
-      height[e.from]++;
+      buckets.pop(level);
+      const int from = height[e.from]++;
       nextEdgeIdx[e.from] = 0;
 
+      if (heuristics.gap) {
+        atHeight.erase(from, e.from);
+        if (atHeight.empty(from)) {
+          // Vertices above 'from' cannot reach a vertex with sink capacity.
+          for (int b = from + 1; b <= top; ++b)
+            while (!atHeight.empty(b)) {
+              const V v = atHeight.front(b);
+              atHeight.erase(b, v);
+              height[v] = maxH;
+            }
+          top = from - 1;
+          height[e.from] = maxH;
+        } else if (height[e.from] < maxH) {
+          atHeight.insert(height[e.from], e.from);
+          top = std::max(top, int(height[e.from]));
+        }
+      }
+
       if (height[e.from] < maxH)
-        q[height[e.from]].push(e.from);
+        buckets.push(height[e.from], e.from);
+      else
+        stuck.push_back(e.from);
+
+      if (heuristics.globalRelabel && ++relabels >= Volume(size())) {
+        relabels = 0;
+        globalRelabel(maxH, stuck);
+        if (heuristics.gap)
+          fillHeights(maxH), top = maxH - 1;
+        level = 0;
+      }
     } else {
       nextEdgeIdx[e.from]++;
     }
   }
+}
+
+template <typename V, template <typename, typename> class A>
+void BasicGraph<V, A>::globalRelabel(const int maxH, std::vector<V> &stuck) {
+  if (distance.size() < absorbed.size())
+    distance.resize(absorbed.size());
+
+  auto &q = relabelQueue;
+  q.clear();
+  for (auto u : *this) {
+    distance[u] = maxH;
+    if (absorbed[u] < sink[u])
+      distance[u] = 0, q.push_back(u);
+  }
+
+  // Search backwards along edges with residual capacity, stopping at 'maxH'.
+  for (size_t i = 0; i < q.size() && distance[q[i]] + 1 < maxH; ++i) {
+    const V v = q[i];
+    for (auto e = beginEdge(v); e != endEdge(v); ++e)
+      if (distance[e->to] == maxH && reverse(*e).residual() > 0)
+        distance[e->to] = distance[v] + 1, q.push_back(e->to);
+  }
+
+  for (auto u : *this) {
+    height[u] = std::max(height[u], distance[u]);
+    nextEdgeIdx[u] = 0;
+  }
+
+  // Pushing to a vertex with excess is avoided by processing lower vertices
+  // first, which requires active vertices to be in the bucket of their height.
+  q.clear();
+  for (int b = int(buckets.nextNonEmpty(0)); b <= maxH;
+       b = int(buckets.nextNonEmpty(b)))
+    for (; !buckets.empty(b); buckets.pop(b))
+      q.push_back(buckets.front(b));
+  for (auto u : q)
+    if (height[u] < maxH)
+      buckets.push(height[u], u);
+    else
+      stuck.push_back(u);
+}
+
+template <typename V, template <typename, typename> class A>
+void BasicGraph<V, A>::fillHeights(const int maxH) {
+  atHeight.reserve(absorbed.size(), size_t(maxH));
+  for (int b = 0; b < maxH; ++b)
+    atHeight.clear(b);
+  for (auto u : *this)
+    if (height[u] < maxH)
+      atHeight.insert(height[u], u);
+}
+
+template <typename V, template <typename, typename> class A>
+std::vector<V> BasicGraph<V, A>::compute(const int maxHeight,
+                                         Heuristics heuristics) {
+  const int maxH = int(std::min<Volume>(maxHeight, Volume(size()) * 2 + 1));
+
+  // Buckets are empty after each call, since the loop below only ends once
+  // every bucket is.
+  buckets.reserve(absorbed.size(), size_t(maxH) + 1);
+
+  // Active vertices start in the bucket of their height, such that lower
+  // vertices are processed first and no flow is pushed to a vertex with
+  // excess, even if heights are left from a previous call. Removing neighbors
+  // since may also have left the edge cursor past the last edge.
+  for (auto u : *this)
+    if (excess(u) > 0) {
+      if (nextEdgeIdx[u] >= degree(u))
+        nextEdgeIdx[u] = 0;
+      buckets.push(std::min(int(height[u]), maxH), u);
+    }
+
+  std::vector<V> stuck;
+  if (heuristics.globalRelabel)
+    globalRelabel(maxH, stuck);
+  pushRelabel(maxH, stuck, heuristics);
 
   for (auto u : *this)
     for (auto e = beginEdge(u); e != endEdge(u); ++e)
       if (e->flow > 0)
         e->congestion += e->flow;
 
-  std::vector<UnitFlow::Vertex> hasExcess;
+  std::vector<V> hasExcess;
   for (auto u : *this)
     if (excess(u) > 0)
       hasExcess.push_back(u);
@@ -95,59 +255,76 @@ std::vector<Vertex> Graph::compute(const int maxHeight) {
   return hasExcess;
 }
 
-std::pair<std::vector<Vertex>, std::vector<Vertex>>
-Graph::levelCut(const int h) {
-  std::vector<std::vector<Vertex>> levels(h + 1);
-  for (auto u : *this)
-    levels[height[u]].push_back(u);
-
-  int volume = 0;
-  // int bestZ = INT_MAX;
-  double bestConductance = 1.0;
-  int bestLevel = h;
-  for (int level = h; level > 0; --level) {
-    int z = 0;
-    for (auto u : levels[level]) {
-      volume += degree(u);
+template <typename V, template <typename, typename> class A>
+std::vector<V> BasicGraph<V, A>::resume(const int maxHeight,
+                                        std::vector<V> touched,
+                                        Heuristics heuristics) {
+  const int maxH = int(std::min<Volume>(maxHeight, Volume(size()) * 2 + 1));
+  buckets.reserve(absorbed.size(), size_t(maxH) + 1);
+
+  // Activate vertices in the order 'compute' would.
+  const auto byPosition = [this](V u, V v) {
+    return this->position(u) < this->position(v);
+  };
+  touched.erase(std::remove_if(touched.begin(), touched.end(),
+                               [this](V u) {
+                                 return !this->alive(u) || excess(u) == 0;
+                               }),
+                touched.end());
+  std::sort(touched.begin(), touched.end(), byPosition);
+  touched.erase(std::unique(touched.begin(), touched.end()), touched.end());
+
+  for (auto u : touched) {
+    // Removing neighbors may leave the edge cursor past the last edge.
+    if (nextEdgeIdx[u] >= degree(u))
+      nextEdgeIdx[u] = 0;
+    buckets.push(std::min(int(height[u]), maxH), u);
+  }
+
+  std::vector<V> stuck;
+  pushRelabel(maxH, stuck, heuristics);
+  std::sort(stuck.begin(), stuck.end(), byPosition);
+  return stuck;
+}
+
+template <typename V, template <typename, typename> class A>
+std::pair<std::vector<V>, std::vector<V>>
+BasicGraph<V, A>::levelCut(const int h) {
+  levels.clear(h);
+  for (auto u : *this) {
+    Volume z = 0;
+    if (height[u] > 0)
       for (auto e = beginEdge(u); e != endEdge(u); ++e)
         if (height[u] == height[e->to] + 1)
           z++;
-    }
-    double conductance =
-        double(z) / double(std::min(volume, this->volume() - volume));
-    if (conductance < bestConductance)
-      bestConductance = conductance, bestLevel = level;
+    levels.add(height[u], u, degree(u), z);
   }
 
-  std::vector<int> left, right;
-  for (int level = h; level >= bestLevel; --level)
-    for (auto u : levels[level])
-      left.push_back(u);
-  for (int level = 0; level < bestLevel; ++level)
-    for (auto u : levels[level])
-      right.push_back(u);
-
-  return std::make_pair(left, right);
+  return levels.cut(this->volume());
 }
 
-void Graph::reset() {
+template <typename V, template <typename, typename> class A>
+void BasicGraph<V, A>::reset() {
   for (auto u : *this) {
     for (auto e = beginEdge(u); e != endEdge(u); ++e)
       e->flow = 0;
     absorbed[u] = 0;
     sink[u] = 0;
+    outflow[u] = 0;
     height[u] = 0;
     nextEdgeIdx[u] = 0;
   }
 }
 
-std::vector<std::pair<Vertex, Vertex>>
-Graph::matchingDfs(const std::vector<Vertex> &sources) {
-  std::vector<std::pair<Vertex, Vertex>> matches;
+template <typename V, template <typename, typename> class A>
+std::vector<std::pair<V, V>>
+BasicGraph<V, A>::matchingDfs(const std::vector<V> &sources) {
+  auto &visited = this->visited;
+  std::vector<std::pair<V, V>> matches;
 
-  auto search = [&](Vertex start) {
+  auto search = [&](V start) {
     std::vector<Edge *> path;
-    std::function<Vertex(Vertex)> dfs = [&](Vertex u) {
+    std::function<V(V)> dfs = [&](V u) -> V {
       visited[u] = start + 1;
 
       if (absorbed[u] > 0 && sink[u] > 0) {
@@ -156,12 +333,12 @@ Graph::matchingDfs(const std::vector<Vertex> &sources) {
       }
 
       for (auto e = beginEdge(u); e != endEdge(u); ++e) {
-        int v = e->to;
+        V v = e->to;
         if (e->flow <= 0 || visited[v] == start + 1)
           continue;
 
         path.push_back(&*e);
-        int m = dfs(v);
+        V m = dfs(v);
         if (m != -1)
           return m;
         path.pop_back();
@@ -170,15 +347,15 @@ Graph::matchingDfs(const std::vector<Vertex> &sources) {
       return -1;
     };
 
-    int m = dfs(start);
+    V m = dfs(start);
     if (m != -1)
       for (auto e : path)
-        e->flow--;
+        e->flow--, outflow[e->from]--;
     return m;
   };
 
   for (auto u : sources) {
-    int m = search(u);
+    V m = search(u);
     if (m != -1)
       matches.push_back({u, m});
   }
@@ -189,19 +366,20 @@ Graph::matchingDfs(const std::vector<Vertex> &sources) {
   return matches;
 }
 
-std::vector<std::pair<Vertex, Vertex>>
-Graph::matchingLinkCut(const std::vector<Vertex> &sources) {
+template <typename V, template <typename, typename> class A>
+std::vector<std::pair<V, V>>
+BasicGraph<V, A>::matchingLinkCut(const std::vector<V> &sources) {
   const int inf = 1 << 30;
 
   forest.reset(cbegin(), cend());
   for (auto it = cbegin(); it != cend(); ++it)
     nextEdgeIdx[*it] = 0;
 
-  std::vector<std::pair<Vertex, Vertex>> matches;
+  std::vector<std::pair<V, V>> matches;
 
-  auto search = [&](Vertex start) {
+  auto search = [&](V start) -> V {
     while (true) {
-      auto u = forest.findRoot(start);
+      V u = V(forest.findRoot(start));
       assert(forest.get(u) == inf);
 
       if (absorbed[u] > 0 && sink[u] > 0)
@@ -215,7 +393,7 @@ Graph::matchingLinkCut(const std::vector<Vertex> &sources) {
         forest.link(u, e.to, e.flow);
         e.flow = 0;
 
-        u = forest.findRoot(start);
+        u = V(forest.findRoot(start));
         if (absorbed[u] > 0 && sink[u] > 0)
           return absorbed[u]--, sink[u]--, u;
       }
@@ -259,11 +437,18 @@ Graph::matchingLinkCut(const std::vector<Vertex> &sources) {
   return matches;
 }
 
-std::vector<std::pair<Vertex, Vertex>>
-Graph::matching(const std::vector<Vertex> &sources, MatchingMethod method) {
+template <typename V, template <typename, typename> class A>
+std::vector<std::pair<V, V>>
+BasicGraph<V, A>::matching(const std::vector<V> &sources,
+                           MatchingMethod method) {
   if (method == MatchingMethod::Dfs)
     return matchingDfs(sources);
   else
     return matchingLinkCut(sources);
 }
+template struct BasicEdge<int32_t>;
+template struct BasicEdge<int64_t>;
+template class BasicGraph<int32_t>;
+template class BasicGraph<int64_t>;
+template class BasicGraph<int32_t, SubsetGraph::NestedAdjacency>;
 } // namespace UnitFlow
@@ -1,30 +1,42 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <list>
 #include <queue>
 #include <vector>
 
+#include "bucket_queue.hpp"
+#include "huge_pages.hpp"
+#include "level_cut.hpp"
 #include "linkcut.hpp"
 #include "subset_graph.hpp"
 
 namespace UnitFlow {
 
-using Vertex = int;
 using Flow = long long;
+using SubsetGraph::Volume;
 
-struct Edge {
-  Vertex from, to, revIdx;
+/**
+   Edge of a flow graph. 'V' is the integer type of vertex indices.
+ */
+template <typename V> struct BasicEdge {
+  V from, to, revIdx;
   Flow flow, capacity, congestion;
 
-  Edge(Vertex from, Vertex to, Flow flow, Flow capacity, Flow congestion);
+  BasicEdge(V from, V to, Flow flow, Flow capacity, Flow congestion);
 
-  Edge(Vertex from, Vertex to, Flow flow, Flow capacity);
+  BasicEdge(V from, V to, Flow flow, Flow capacity);
   /**
      Construct an edge between two vertices with a certain capacity and zero
      flow.
    */
-  Edge(Vertex from, Vertex to, Flow capacity);
+  BasicEdge(V from, V to, Flow capacity);
+
+  /**
+     Construct an edge between two vertices with zero capacity and flow.
+   */
+  BasicEdge(V from, V to);
 
   /**
      Residual capacity. I.e. the amount of capacity left over.
@@ -36,45 +48,108 @@ struct Edge {
      set to zero. 'revIdx' remains undefined since it is maintained by the graph
      representation.
   */
-  Edge reverse() const {
-    Edge e{to, from, 0, capacity};
+  BasicEdge reverse() const {
+    BasicEdge e{to, from, 0, capacity};
     return e;
   }
 
   /**
      Two edges are equal if all their fields agree, including reverse index.
   */
-  friend bool operator==(const Edge &lhs, const Edge &rhs) {
+  friend bool operator==(const BasicEdge &lhs, const BasicEdge &rhs) {
     return lhs.from == rhs.from && lhs.to == rhs.to &&
            lhs.revIdx == rhs.revIdx && lhs.flow == rhs.flow &&
            lhs.capacity == rhs.capacity;
   }
 };
 
+/**
+   Optional heuristics of push-relabel. Both only raise heights, lifting
+   vertices which cannot reach a vertex with sink capacity left to the max
+   height at once instead of one relabel at a time. Enabling either changes
+   the flow found, and hence cuts derived from it.
+ */
+struct Heuristics {
+  /**
+     Set heights to the residual distance to a vertex with sink capacity left,
+     capped by the max height, using a reverse breadth-first search. Done at
+     the start of 'compute' and after every 'size()' relabels.
+   */
+  bool globalRelabel = false;
+
+  /**
+     When a relabel leaves no vertex at a height, lift every vertex above it
+     to the max height. Costs O(n + h) at the start of each computation.
+   */
+  bool gap = false;
+};
+
 /**
    Push relabel based unit flow algorithm. Based on push relabel in KACTL.
+
+   Instantiated for 32-bit and 64-bit vertex indices 'V' with flat adjacency
+   storage 'A', and for 32-bit indices with nested adjacency storage.
  */
-class Graph : public SubsetGraph::Graph<int, Edge> {
+template <typename V,
+          template <typename, typename> class A = SubsetGraph::FlatAdjacency>
+class BasicGraph
+    : public SubsetGraph::Graph<V, BasicEdge<V>, A<V, BasicEdge<V>>> {
+public:
+  using Vertex = V;
+  using Edge = BasicEdge<V>;
+  using Base = SubsetGraph::Graph<V, Edge, A<V, Edge>>;
+
+  using Base::beginEdge;
+  using Base::cbegin;
+  using Base::cbeginEdge;
+  using Base::cend;
+  using Base::cendEdge;
+  using Base::degree;
+  using Base::endEdge;
+  using Base::getEdge;
+  using Base::reverse;
+  using Base::size;
+
 private:
   /**
      The amount of flow a vertex is absorbing. In the beginning, before any flow
      has been moved, this corresponds to the source function '\Delta(v)'.
    */
-  std::vector<Flow> absorbed;
+  HugePages::Vector<Flow> absorbed;
   /**
      The sink capacity of a vertex, i.e. the amount of flow possible to absorb.
    */
-  std::vector<Flow> sink;
+  HugePages::Vector<Flow> sink;
+  /**
+     The amount of flow leaving a vertex along edges with positive flow, kept
+     up to date as flow is pushed or matched.
+   */
+  HugePages::Vector<Flow> outflow;
   /**
      The height of a vertex.
    */
-  std::vector<Vertex> height;
+  HugePages::Vector<Vertex> height;
 
   /**
      For each vertex, keep track of which edge in their neighbor list they
      should consider next.
    */
-  std::vector<int> nextEdgeIdx;
+  HugePages::Vector<Vertex> nextEdgeIdx;
+
+  /**
+     Active vertices by height in 'compute' and vertices at each height in
+     'levelCut'. Kept between calls such that they are not reallocated by each
+     call.
+   */
+  BucketQueue::Buckets<Vertex> buckets;
+  LevelCut::Levels<Vertex, Volume> levels;
+
+  /**
+     Vertices below the max height by height for the gap heuristic, and
+     distances and search queue of the global relabel heuristic.
+   */
+  BucketQueue::Sets<Vertex> atHeight;
+  std::vector<Vertex> distance, relabelQueue;
 
   /**
      Residual capacity of an edge.
@@ -90,12 +165,30 @@ public:
   /**
      Construct a unit flow problem with 'n' vertices and edges 'es'.
    */
-  Graph(int n, const std::vector<Edge> &es);
+  BasicGraph(Vertex n, const std::vector<Edge> &es);
 
-  const std::vector<Flow> &getAbsorbed() const { return absorbed; }
-  const std::vector<Flow> &getSink() const { return sink; }
-  const std::vector<Vertex> &getHeight() const { return height; }
-  const std::vector<int> &getNextEdgeIdx() const { return nextEdgeIdx; }
+  /**
+     Construct a unit flow problem with 'n' vertices from an adjacency array.
+     All edges have zero capacity. See 'SubsetGraph::Graph' for requirements
+     on 'offsets' and 'neighbors'.
+   */
+  template <typename O, typename N>
+  BasicGraph(Vertex n, const O *offsets, const N *neighbors)
+      : Base(n, offsets, neighbors), absorbed(n), sink(n), outflow(n),
+        height(n), nextEdgeIdx(n), forest(n) {}
+
+  /**
+     Replace the problem by one with 'n' vertices and edges 'es'. Storage of the
+     previous problem is reused.
+   */
+  void assign(Vertex n, const std::vector<Edge> &es);
+
+  const HugePages::Vector<Flow> &getAbsorbed() const { return absorbed; }
+  const HugePages::Vector<Flow> &getSink() const { return sink; }
+  const HugePages::Vector<Vertex> &getHeight() const { return height; }
+  const HugePages::Vector<Vertex> &getNextEdgeIdx() const {
+    return nextEdgeIdx;
+  }
 
   /**
      Add an undirected edge '{u,v}' with a certain capacity. If 'u = v' do
@@ -122,19 +215,12 @@ public:
   Flow flowIn(Vertex u) const { return absorbed[u]; }
 
   /**
-     The amount of flow leaving vertex.
-
-     Time complexity: O(m)
+     The amount of flow leaving vertex since the last reset, including flow
+     along edges to vertices removed since.
 
-     TODO: make this function O(1)
+     Time complexity: O(1)
    */
-  Flow flowOut(Vertex u) const {
-    Flow f = 0;
-    for (auto e = cbeginEdge(u); e != cendEdge(u); ++e)
-      if (e->flow > 0)
-        f += e->flow;
-    return f;
-  }
+  Flow flowOut(Vertex u) const { return outflow[u]; }
 
   /**
      Return the excess of a node, i.e. the flow it cannot absorb.
@@ -148,7 +234,20 @@ public:
      with excess flow left over. If an empty vector is returned then all flow
      was possible to route.
    */
-  std::vector<Vertex> compute(const int maxHeight);
+  std::vector<Vertex> compute(const int maxHeight,
+                              Heuristics heuristics = {});
+
+  /**
+     Continue a flow computed by 'compute' with the same max height h after
+     vertices were removed or gained source. 'touched' must contain every
+     vertex which gained source since, together with the vertices returned by
+     the previous call. Only touched vertices with excess are activated, and
+     heights and flow are kept, so the work done is roughly that caused by the
+     change. Return the same as 'compute', but unlike 'compute' congestion is
+     not updated.
+   */
+  std::vector<Vertex> resume(const int maxHeight, std::vector<Vertex> touched,
+                             Heuristics heuristics = {});
 
   /**
      Compute a level cut. See Saranurak and Wang A.1.
@@ -164,20 +263,53 @@ public:
   void reset();
 
   /**
-     Set all flow, sinks and source capacities of a subset of vertices to 0.
+     Bytes allocated by the graph.
+   */
+  Memory::Usage memoryUsage() const;
+
+  /**
+     Set all flow, sinks and source capacities of the vertices in '[begin,end)'
+     to 0. Flow on an edge to a vertex outside the range is also cleared on
+     its reverse, and the outflow of that vertex adjusted.
    */
   template <typename It> void reset(const It begin, const It end) {
-    for (auto u : *this) {
-      for (auto e = beginEdge(u); e != endEdge(u); ++e)
+    for (auto it = begin; it != end; ++it) {
+      const auto u = *it;
+      for (auto e = beginEdge(u); e != endEdge(u); ++e) {
+        if (e->flow < 0)
+          outflow[e->to] += e->flow;
         e->flow = 0;
+        reverse(*e).flow = 0;
+      }
       absorbed[u] = 0;
       sink[u] = 0;
+      outflow[u] = 0;
       height[u] = 0;
       nextEdgeIdx[u] = 0;
     }
   }
 
 private:
+  /**
+     Push and relabel until no vertex in 'buckets' remains. Vertices left with
+     excess are appended to 'stuck'.
+   */
+  void pushRelabel(const int maxH, std::vector<Vertex> &stuck,
+                   Heuristics heuristics);
+
+  /**
+     Raise heights to the residual distance to a vertex with sink capacity
+     left, or 'maxH' if it is at least 'maxH', and reset edge cursors. Active
+     vertices are moved to the buckets of their new heights, or appended to
+     'stuck' if lifted to 'maxH'.
+   */
+  void globalRelabel(const int maxH, std::vector<Vertex> &stuck);
+
+  /**
+     Put every alive vertex below height 'maxH' in 'atHeight'.
+   */
+  void fillHeights(const int maxH);
+
   std::vector<std::pair<Vertex, Vertex>>
   matchingDfs(const std::vector<Vertex> &sources);
 
@@ -205,4 +337,17 @@ public:
   std::vector<std::pair<Vertex, Vertex>>
   matching(const std::vector<Vertex> &sources, MatchingMethod method);
 };
+/**
+   Flow graph with 32-bit vertex indices, sufficient unless the subdivision
+   graph has more than 2^31 vertices.
+ */
+using Vertex = int;
+using Edge = BasicEdge<int>;
+using Graph = BasicGraph<int>;
+
+extern template struct BasicEdge<int32_t>;
+extern template struct BasicEdge<int64_t>;
+extern template class BasicGraph<int32_t>;
+extern template class BasicGraph<int64_t>;
+extern template class BasicGraph<int32_t, SubsetGraph::NestedAdjacency>;
 } // namespace UnitFlow
@@ -1,5 +1,6 @@
 #include <glog/logging.h>
 #include <glog/stl_logging.h>
+#include <limits>
 #include <memory>
 #include <numeric>
 
@@ -9,42 +10,76 @@
 
 namespace ExpanderDecomposition {
 
-std::unique_ptr<UnitFlow::Graph>
-constructFlowGraph(const std::unique_ptr<Undirected::Graph> &g) {
-  std::vector<UnitFlow::Edge> es;
-  for (auto u : *g)
-    for (auto e = g->cbeginEdge(u); e != g->cendEdge(u); ++e)
+namespace {
+
+/**
+   Set 'es' to the edges of a flow graph equivalent to 'g'.
+ */
+template <typename V>
+void flowGraphEdges(const Undirected::BasicGraph<V> &g,
+                    std::vector<UnitFlow::BasicEdge<V>> &es) {
+  es.clear();
+  for (auto u = g.cbegin(); u != g.cend(); ++u)
+    for (auto e = g.cbeginEdge(*u); e != g.cendEdge(*u); ++e)
       if (e->from < e->to)
         es.emplace_back(e->from, e->to, 0);
+}
+
+} // namespace
 
-  return std::make_unique<UnitFlow::Graph>(g->size(), es);
+template <typename V>
+std::unique_ptr<UnitFlow::BasicGraph<V>>
+constructFlowGraph(const std::unique_ptr<Undirected::BasicGraph<V>> &g) {
+  std::vector<UnitFlow::BasicEdge<V>> es;
+  flowGraphEdges(*g, es);
+  return std::make_unique<UnitFlow::BasicGraph<V>>(g->size(), es);
 }
 
-std::unique_ptr<UnitFlow::Graph>
-constructSubdivisionFlowGraph(const std::unique_ptr<Undirected::Graph> &g) {
-  std::vector<UnitFlow::Edge> es;
-  for (auto u : *g)
-    for (auto e = g->cbeginEdge(u); e != g->cendEdge(u); ++e)
-      if (e->from < e->to) {
-        UnitFlow::Vertex splitVertex = g->size() + int(es.size()) / 2;
-        es.emplace_back(e->from, splitVertex, 0);
-        es.emplace_back(e->to, splitVertex, 0);
-      }
-  return std::make_unique<UnitFlow::Graph>(g->size() + int(es.size()) / 2, es);
+template <typename V>
+std::unique_ptr<SubdivisionFlow::BasicGraph<V>> constructSubdivisionFlowGraph(
+    const std::unique_ptr<Undirected::BasicGraph<V>> &g) {
+  return std::make_unique<SubdivisionFlow::BasicGraph<V>>(*g);
 }
 
-Solver::Solver(std::unique_ptr<Undirected::Graph> graph, double phi,
-               std::mt19937 *randomGen, CutMatching::Parameters params)
+template <typename V>
+BasicSolver<V>::BasicSolver(double phi, std::mt19937 *randomGen,
+                            CutMatching::Parameters params,
+                            double extractFraction,
+                            UnitFlow::Heuristics trimmingHeuristics)
     : flowGraph(nullptr), subdivisionFlowGraph(nullptr), randomGen(randomGen),
-      subdivisionIdx(nullptr), phi(phi), cutMatchingParams(params),
-      numPartitions(0), partitionOf(graph->size(), -1) {
-  flowGraph = constructFlowGraph(graph);
-  subdivisionFlowGraph = constructSubdivisionFlowGraph(graph);
-
-  subdivisionIdx =
-      std::make_unique<std::vector<int>>(subdivisionFlowGraph->size(), -1);
-  for (int u = flowGraph->size(); u < subdivisionFlowGraph->size(); ++u)
-    (*subdivisionIdx)[u] = 0;
+      subdivisionIdx(std::make_unique<std::vector<V>>()), storageSize(0),
+      extractedBytes(0), peakExtractedBytes(0), phi(phi),
+      cutMatchingParams(params), extractFraction(extractFraction),
+      trimmingHeuristics(trimmingHeuristics), numPartitions(0) {}
+
+template <typename V>
+BasicSolver<V>::BasicSolver(std::unique_ptr<Graph> graph, double phi,
+                            std::mt19937 *randomGen,
+                            CutMatching::Parameters params,
+                            double extractFraction,
+                            UnitFlow::Heuristics trimmingHeuristics)
+    : BasicSolver(phi, randomGen, params, extractFraction,
+                  trimmingHeuristics) {
+  decompose(std::move(graph));
+}
+
+template <typename V>
+void BasicSolver<V>::decompose(std::unique_ptr<Graph> graph) {
+  CHECK_LE(UnitFlow::Volume(graph->size()) + graph->edgeCount(),
+           UnitFlow::Volume(std::numeric_limits<V>::max()))
+      << "Subdivision graph has too many vertices for the index type.";
+
+  assignFlowGraphs(*graph);
+  labels.clear();
+  storageSize = graph->size();
+  if (extractFraction > 0)
+    localIdx.assign(graph->size(), -1);
+  else
+    localIdx.clear();
+
+  numPartitions = 0;
+  partitionOf.assign(graph->size(), -1);
+  congestionOf.clear();
 
   VLOG(1) << "Preparing to run expander decomposition."
           << "\n\tGraph: " << graph->size() << " vertices and "
@@ -59,7 +94,105 @@ Solver::Solver(std::unique_ptr<Undirected::Graph> graph, double phi,
   compute();
 }
 
-void Solver::compute() {
+template <typename V> void BasicSolver<V>::assignFlowGraphs(const Graph &g) {
+  flowGraphEdges(g, flowEdges);
+  if (flowGraph)
+    flowGraph->assign(g.size(), flowEdges);
+  else
+    flowGraph = std::make_unique<FlowGraph>(g.size(), flowEdges);
+  flowEdges.clear();
+
+  if (subdivisionFlowGraph)
+    subdivisionFlowGraph->assign(g);
+  else
+    subdivisionFlowGraph = std::make_unique<SubdivisionFlowGraph>(g);
+
+  subdivisionIdx->assign(subdivisionFlowGraph->size(), -1);
+  for (V u = flowGraph->size(); u < subdivisionFlowGraph->size(); ++u)
+    (*subdivisionIdx)[u] = 0;
+}
+
+template <typename V>
+void BasicSolver<V>::computeSubgraph(const std::vector<V> &xs) {
+  if (double(xs.size()) < extractFraction * double(storageSize)) {
+    computeExtracted(xs);
+    return;
+  }
+
+  auto subXs = subdivisionFlowGraph->subdivisionVertices(xs.begin(), xs.end());
+  flowGraph->subgraph(xs.begin(), xs.end());
+  subdivisionFlowGraph->subgraph(subXs.begin(), subXs.end());
+  compute();
+  flowGraph->restoreSubgraph();
+  subdivisionFlowGraph->restoreSubgraph();
+}
+
+template <typename V>
+void BasicSolver<V>::computeExtracted(const std::vector<V> &xs) {
+  VLOG(1) << "Extracting subproblem with " << xs.size() << " of "
+          << storageSize << " vertices.";
+
+  const V k = V(xs.size());
+  for (V i = 0; i < k; ++i)
+    localIdx[xs[i]] = i;
+
+  // Every edge of 'xs' is copied, also those leaving the current subgraph
+  // which are past the end of its adjacency list.
+  std::vector<V> outside;
+  std::vector<Undirected::BasicEdge<V>> es;
+  for (const V u : xs) {
+    const auto *edges = flowGraph->cbeginEdge(u);
+    for (V i = 0; i < flowGraph->globalDegree(u); ++i) {
+      V &v = localIdx[edges[i].to];
+      if (v == -1)
+        v = k + V(outside.size()), outside.push_back(edges[i].to);
+      if (localIdx[u] < v)
+        es.emplace_back(localIdx[u], v);
+    }
+  }
+  for (const V u : xs)
+    localIdx[u] = -1;
+  for (const V u : outside)
+    localIdx[u] = -1;
+
+  std::vector<V> extractedLabels(k);
+  for (V i = 0; i < k; ++i)
+    extractedLabels[i] = labels.empty() ? xs[i] : labels[xs[i]];
+
+  auto parentFlowGraph = std::move(flowGraph);
+  auto parentSubdivisionFlowGraph = std::move(subdivisionFlowGraph);
+  auto parentSubdivisionIdx = std::move(subdivisionIdx);
+  const V parentStorageSize = storageSize;
+  std::swap(labels, extractedLabels);
+  subdivisionIdx = std::make_unique<std::vector<V>>();
+  storageSize = k;
+  assignFlowGraphs(Graph(k + V(outside.size()), es));
+
+  // Vertices outside of 'xs' are excluded, but the split vertices of their
+  // edges to 'xs' remain as in the current subgraph.
+  std::vector<V> vs(k);
+  std::iota(vs.begin(), vs.end(), 0);
+  flowGraph->subgraph(vs.begin(), vs.end());
+  for (V u = flowGraph->size() + V(outside.size());
+       u < subdivisionFlowGraph->size(); ++u)
+    vs.push_back(u);
+  subdivisionFlowGraph->subgraph(vs.begin(), vs.end());
+
+  const size_t bytes = flowGraph->memoryUsage().total() +
+                       subdivisionFlowGraph->memoryUsage().total();
+  extractedBytes += bytes;
+  peakExtractedBytes = std::max(peakExtractedBytes, extractedBytes);
+  compute();
+  extractedBytes -= bytes;
+
+  flowGraph = std::move(parentFlowGraph);
+  subdivisionFlowGraph = std::move(parentSubdivisionFlowGraph);
+  subdivisionIdx = std::move(parentSubdivisionIdx);
+  storageSize = parentStorageSize;
+  std::swap(labels, extractedLabels);
+}
+
+template <typename V> void BasicSolver<V>::compute() {
   VLOG(1) << "Attempting to find balanced cut with " << flowGraph->size()
           << " vertices.";
   if (flowGraph->size() == 0) {
@@ -76,24 +209,17 @@ void Solver::compute() {
   if (components.size() > 1) {
     VLOG(1) << "Found " << components.size() << " connected components.";
 
-    for (auto &comp : components) {
-      auto subComp =
-          subdivisionFlowGraph->subdivisionVertices(comp.begin(), comp.end());
-
-      flowGraph->subgraph(comp.begin(), comp.end());
-      subdivisionFlowGraph->subgraph(subComp.begin(), subComp.end());
-
-      compute();
-
-      flowGraph->restoreSubgraph();
-      subdivisionFlowGraph->restoreSubgraph();
-    }
+    for (auto &comp : components)
+      computeSubgraph(comp);
   } else {
-    CutMatching::Solver cm(flowGraph.get(), subdivisionFlowGraph.get(),
-                           randomGen, subdivisionIdx.get(), phi,
-                           cutMatchingParams);
+    CutMatching::BasicSolver<V> cm(flowGraph.get(), subdivisionFlowGraph.get(),
+                                   randomGen, subdivisionIdx.get(), phi,
+                                   cutMatchingParams);
     auto result = cm.compute(cutMatchingParams);
-    std::vector<int> a, r;
+    const auto usage = cm.memoryUsage();
+    if (usage.total() > peakCutMatching.total())
+      peakCutMatching = usage;
+    std::vector<V> a, r;
     std::copy(flowGraph->cbegin(), flowGraph->cend(), std::back_inserter(a));
     std::copy(flowGraph->cbeginRemoved(), flowGraph->cendRemoved(),
               std::back_inserter(r));
@@ -106,27 +232,16 @@ void Solver::compute() {
       flowGraph->restoreRemoves();
       subdivisionFlowGraph->restoreRemoves();
 
-      auto subA = subdivisionFlowGraph->subdivisionVertices(a.begin(), a.end());
-      auto subR = subdivisionFlowGraph->subdivisionVertices(r.begin(), r.end());
-
-      flowGraph->subgraph(a.begin(), a.end());
-      subdivisionFlowGraph->subgraph(subA.begin(), subA.end());
-      compute();
-      flowGraph->restoreSubgraph();
-      subdivisionFlowGraph->restoreSubgraph();
-
-      flowGraph->subgraph(r.begin(), r.end());
-      subdivisionFlowGraph->subgraph(subR.begin(), subR.end());
-      compute();
-      flowGraph->restoreSubgraph();
-      subdivisionFlowGraph->restoreSubgraph();
+      computeSubgraph(a);
+      computeSubgraph(r);
       break;
     }
     case CutMatching::Result::NearExpander: {
       assert(!a.empty() && "Near expander should have non-empty A.");
       assert(!r.empty() && "Near expander should have non-empty R.");
 
-      Trimming::Solver trimming(flowGraph.get(), phi);
+      Trimming::BasicSolver<V> trimming(flowGraph.get(), phi,
+                                        trimmingHeuristics);
       trimming.compute();
 
       assert(flowGraph->size() > 0 &&
@@ -140,12 +255,7 @@ void Solver::compute() {
       flowGraph->restoreRemoves();
       subdivisionFlowGraph->restoreRemoves();
 
-      auto subR = subdivisionFlowGraph->subdivisionVertices(r.begin(), r.end());
-      flowGraph->subgraph(r.begin(), r.end());
-      subdivisionFlowGraph->subgraph(subR.begin(), subR.end());
-      compute();
-      flowGraph->restoreSubgraph();
-      subdivisionFlowGraph->restoreSubgraph();
+      computeSubgraph(r);
       break;
     }
     case CutMatching::Result::Expander: {
@@ -165,9 +275,27 @@ void Solver::compute() {
   }
 }
 
-std::vector<std::vector<int>> Solver::getPartition() const {
-  std::vector<std::vector<int>> result(numPartitions);
-  std::vector<int> tmp;
+template <typename V> Memory::Usage BasicSolver<V>::memoryUsage() const {
+  Memory::Usage usage;
+  if (flowGraph)
+    usage.add("flowGraph", flowGraph->memoryUsage());
+  if (subdivisionFlowGraph)
+    usage.add("subdivisionFlowGraph", subdivisionFlowGraph->memoryUsage());
+  usage.add("subdivisionIdx", Memory::bytes(*subdivisionIdx));
+  usage.add("flowEdges", Memory::bytes(flowEdges));
+  usage.add("labels", Memory::bytes(labels));
+  usage.add("localIdx", Memory::bytes(localIdx));
+  usage.add("partitionOf", Memory::bytes(partitionOf));
+  usage.add("congestionOf", Memory::bytes(congestionOf));
+  usage.add("peakCutMatching", peakCutMatching);
+  usage.add("peakExtracted", peakExtractedBytes);
+  return usage;
+}
+
+template <typename V>
+std::vector<std::vector<V>> BasicSolver<V>::getPartition() const {
+  std::vector<std::vector<V>> result(numPartitions);
+  std::vector<V> tmp;
   for (auto u : *flowGraph) {
     tmp.push_back(u);
     assert(partitionOf[u] != -1 && "Vertex not part of partition.");
@@ -177,18 +305,19 @@ std::vector<std::vector<int>> Solver::getPartition() const {
   return result;
 }
 
-std::vector<double> Solver::getConductance() const {
+template <typename V>
+std::vector<double> BasicSolver<V>::getConductance() const {
   std::vector<double> result(numPartitions);
 
-  for (int i = 0; i < numPartitions; ++i)
+  for (V i = 0; i < numPartitions; ++i)
     if (congestionOf[i] > 0)
       result[i] = 1.0 / double(congestionOf[i]);
 
   return result;
 }
 
-int Solver::getEdgesCut() const {
-  int count = 0;
+template <typename V> UnitFlow::Volume BasicSolver<V>::getEdgesCut() const {
+  UnitFlow::Volume count = 0;
   auto partitions = getPartition();
   for (const auto &p : partitions) {
     assert(!p.empty() && "Partitions should not be empty.");
@@ -203,4 +332,18 @@ int Solver::getEdgesCut() const {
   return count / 2;
 }
 
+template std::unique_ptr<UnitFlow::BasicGraph<int32_t>>
+constructFlowGraph(const std::unique_ptr<Undirected::BasicGraph<int32_t>> &g);
+template std::unique_ptr<UnitFlow::BasicGraph<int64_t>>
+constructFlowGraph(const std::unique_ptr<Undirected::BasicGraph<int64_t>> &g);
+template std::unique_ptr<SubdivisionFlow::BasicGraph<int32_t>>
+constructSubdivisionFlowGraph(
+    const std::unique_ptr<Undirected::BasicGraph<int32_t>> &g);
+template std::unique_ptr<SubdivisionFlow::BasicGraph<int64_t>>
+constructSubdivisionFlowGraph(
+    const std::unique_ptr<Undirected::BasicGraph<int64_t>> &g);
+
+template class BasicSolver<int32_t>;
+template class BasicSolver<int64_t>;
+
 } // namespace ExpanderDecomposition
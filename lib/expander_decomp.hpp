@@ -3,6 +3,8 @@
 #include <vector>
 
 #include "cut_matching.hpp"
+#include "datastructures/memory.hpp"
+#include "datastructures/subdivision_flow.hpp"
 #include "datastructures/undirected_graph.hpp"
 #include "datastructures/unit_flow.hpp"
 
@@ -11,26 +13,38 @@ namespace ExpanderDecomposition {
 /**
    Construct a flow graph equivalent to 'g' with all edge capacities set to 0.
  */
-std::unique_ptr<UnitFlow::Graph>
-constructFlowGraph(const std::unique_ptr<Undirected::Graph> &g);
+template <typename V>
+std::unique_ptr<UnitFlow::BasicGraph<V>>
+constructFlowGraph(const std::unique_ptr<Undirected::BasicGraph<V>> &g);
 
 /**
    Construct a subdivision flow graph from 'g' with all edge capacities set to
    0.
  */
-std::unique_ptr<UnitFlow::Graph>
-constructSubdivisionFlowGraph(const std::unique_ptr<Undirected::Graph> &g);
+template <typename V>
+std::unique_ptr<SubdivisionFlow::BasicGraph<V>> constructSubdivisionFlowGraph(
+    const std::unique_ptr<Undirected::BasicGraph<V>> &g);
 
 /**
-   Constructs and solves a expander decomposition problem.
+   Constructs and solves a expander decomposition problem. 'V' is the integer
+   type of vertex indices, which must be able to index the 'n+m' vertices of
+   the subdivision graph.
  */
-class Solver {
+template <typename V> class BasicSolver {
+public:
+  using Graph = Undirected::BasicGraph<V>;
+  using FlowGraph = UnitFlow::BasicGraph<V>;
+  using SubdivisionFlowGraph = SubdivisionFlow::BasicGraph<V>;
+
 private:
   /**
      Two flow graphs are maintained. Let 'graph = (V,E)'. Then '{e.id + |V| | e
      \in E}' is the vertex ids of the split vertices in 'subdivisionFlowGraph'.
+     The subdivision graph is derived from the edges of 'graph' and only stores
+     the flow state of its edges.
    */
-  std::unique_ptr<UnitFlow::Graph> flowGraph, subdivisionFlowGraph;
+  std::unique_ptr<FlowGraph> flowGraph;
+  std::unique_ptr<SubdivisionFlowGraph> subdivisionFlowGraph;
 
   /**
      Randomness engine.
@@ -44,7 +58,42 @@ private:
      'u' is not a subdivision vertex and 'subdivisionIdx[u] >= 0' if 'u' is a
      subdivision vertex.
    */
-  std::unique_ptr<std::vector<int>> subdivisionIdx;
+  std::unique_ptr<std::vector<V>> subdivisionIdx;
+
+  /**
+     Edges of the flow graph being constructed. Kept such that its storage is
+     reused when decomposing several graphs.
+   */
+  std::vector<typename FlowGraph::Edge> flowEdges;
+
+  /**
+     Vertex of the decomposed graph for each vertex of the flow graph, or empty
+     if they are the same. Differs once a subproblem has been extracted.
+   */
+  std::vector<V> labels;
+
+  /**
+     Number of vertices of the graph the flow graphs were derived from, either
+     the decomposed graph or an extracted subproblem.
+   */
+  V storageSize;
+
+  /**
+     Vertex of an extracted subproblem for each vertex of the flow graph, or -1
+     if not part of it. Only used while extracting.
+   */
+  std::vector<V> localIdx;
+
+  /**
+     Bytes allocated by the graphs of the extracted subproblems being solved,
+     and the most bytes allocated by them at once.
+   */
+  size_t extractedBytes, peakExtractedBytes;
+
+  /**
+     Memory usage of the cut-matching solver with the largest total usage.
+   */
+  Memory::Usage peakCutMatching;
 
   const double phi;
 
@@ -53,16 +102,27 @@ private:
    */
   const CutMatching::Parameters cutMatchingParams;
 
+  /**
+     Subproblems with fewer than 'extractFraction' times the vertices of the
+     graph they are part of are extracted, see 'computeExtracted'.
+   */
+  const double extractFraction;
+
+  /**
+     Push-relabel heuristics used when trimming.
+   */
+  const UnitFlow::Heuristics trimmingHeuristics;
+
   /**
      Number of finalized partitions.
    */
-  int numPartitions;
+  V numPartitions;
 
   /**
      Vector of indices such that 'partitionOf[u]' is the partition index of
      vertex 'u'.
    */
-  std::vector<int> partitionOf;
+  std::vector<V> partitionOf;
 
   /**
      Congestion of expander embedding in each partition.
@@ -74,6 +134,29 @@ private:
    */
   void compute();
 
+  /**
+     Replace the flow graphs by those derived from 'g'. Existing flow graphs
+     are reused.
+   */
+  void assignFlowGraphs(const Graph &g);
+
+  /**
+     Compute expander decomposition for the subgraph induced by 'xs', which
+     must be alive in the current subgraph. Small subgraphs are extracted.
+   */
+  void computeSubgraph(const std::vector<V> &xs);
+
+  /**
+     Compute expander decomposition for the subgraph induced by 'xs' after
+     copying it into new flow graphs with vertices '0,...,|xs|-1'. Neighbors of
+     'xs' outside of it are kept as vertices outside of the current subgraph,
+     such that global degrees are preserved. Deep recursion then works on
+     compact graphs rather than a scattered part of the entire graph.
+
+     Time complexity: O(|xs| + vol(xs))
+   */
+  void computeExtracted(const std::vector<V> &xs);
+
   /**
      Create a partition with the given vertices.
    */
@@ -82,21 +165,45 @@ private:
     assert(congestionOf.size() == numPartitions + 1);
 
     for (auto it = begin; it != end; ++it)
-      partitionOf[*it] = numPartitions;
+      partitionOf[labels.empty() ? *it : labels[*it]] = numPartitions;
     numPartitions++;
   }
 
 public:
+  /**
+     Create a decomposition problem without a graph. Graphs are decomposed
+     using 'decompose'. Subproblems with fewer than 'extractFraction' times
+     the vertices of the graph they are part of are extracted, where '0'
+     disables extraction. Trimming uses 'trimmingHeuristics'.
+   */
+  BasicSolver(double phi, std::mt19937 *randomGen,
+              CutMatching::Parameters params, double extractFraction = 0,
+              UnitFlow::Heuristics trimmingHeuristics = {});
+
   /**
      Create a decomposition problem on graph 'g'.
    */
-  Solver(std::unique_ptr<Undirected::Graph> g, double phi,
-         std::mt19937 *randomGen, CutMatching::Parameters params);
+  BasicSolver(std::unique_ptr<Graph> g, double phi, std::mt19937 *randomGen,
+              CutMatching::Parameters params, double extractFraction = 0,
+              UnitFlow::Heuristics trimmingHeuristics = {});
+
+  /**
+     Compute the expander decomposition of 'g', replacing any previous
+     decomposition. Flow graphs and other storage of the previous
+     decomposition are reused, which avoids reallocating them when many
+     graphs are decomposed by the same solver.
+   */
+  void decompose(std::unique_ptr<Graph> g);
 
   /**
      Return the computed partition as a vector of disjoint vertex vectors.
    */
-  std::vector<std::vector<int>> getPartition() const;
+  std::vector<std::vector<V>> getPartition() const;
+
+  /**
+     Return the partition index of each vertex.
+   */
+  const std::vector<V> &getPartitionOf() const { return partitionOf; }
 
   /**
      Compute lower bound on conductance using congestion from cut-matching game.
@@ -107,6 +214,18 @@ public:
      Return the number of edges which are cut. An edge is cut if it's two
      endpoints are in separate partitions.
    */
-  int getEdgesCut() const;
+  UnitFlow::Volume getEdgesCut() const;
+
+  /**
+     Bytes allocated by the solver. Besides its current storage this includes
+     the largest usage of a cut-matching solver and of the graphs of
+     extracted subproblems, across all graphs decomposed.
+   */
+  Memory::Usage memoryUsage() const;
 };
+
+using Solver = BasicSolver<int>;
+
+extern template class BasicSolver<int32_t>;
+extern template class BasicSolver<int64_t>;
 } // namespace ExpanderDecomposition
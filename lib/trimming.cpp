@@ -5,15 +5,18 @@
 
 namespace Trimming {
 
-Solver::Solver(UnitFlow::Graph *g, const double phi) : graph(g), phi(phi) {}
+template <typename V>
+BasicSolver<V>::BasicSolver(UnitFlow::BasicGraph<V> *g, const double phi,
+                            UnitFlow::Heuristics heuristics)
+    : graph(g), phi(phi), heuristics(heuristics) {}
 
-void Solver::compute() {
+template <typename V> void BasicSolver<V>::compute() {
   VLOG(2) << "Trimming partition with " << graph->size() << " vertices.";
 
   graph->reset();
 
   for (auto u : *graph) {
-    const int removedEdges = graph->globalDegree(u) - graph->degree(u);
+    const V removedEdges = graph->globalDegree(u) - graph->degree(u);
     graph->addSource(u, (UnitFlow::Flow)std::ceil(removedEdges * 2.0 / phi));
     for (auto e = graph->beginEdge(u); e != graph->endEdge(u); ++e)
       e->capacity = (UnitFlow::Flow)ceil(2.0 / phi);
@@ -22,11 +25,11 @@ void Solver::compute() {
     graph->addSink(u, d);
   }
 
-  const int m = graph->edgeCount();
-  const int h = ceil(40 * std::log(2 * m + 1) / phi);
+  const UnitFlow::Volume m = graph->edgeCount();
+  const int h = ceil(40 * std::log(double(2 * m + 1)) / phi);
 
+  auto hasExcess = graph->compute(h, heuristics);
   while (true) {
-    const auto hasExcess = graph->compute(h);
     VLOG(3) << "Found excess of size: " << hasExcess.size();
     if (hasExcess.empty())
       break;
@@ -36,14 +39,28 @@ void Solver::compute() {
     if (levelCut.empty())
       break;
 
+    // Removing a vertex removes its edges, so its neighbors are collected
+    // first. Only vertices left with excess and neighbors of the cut can be
+    // active when the flow is resumed.
+    std::vector<V> touched = std::move(hasExcess);
+    const size_t neighborsBegin = touched.size();
     for (auto u : levelCut)
-      graph->remove(u);
+      for (auto e = graph->beginEdge(u); e != graph->endEdge(u); ++e)
+        touched.push_back(e->to);
 
     for (auto u : levelCut)
-      for (auto e = graph->beginEdge(u); e != graph->endEdge(u); ++e)
-        graph->addSource(e->to, (UnitFlow::Flow)ceil(2.0 / phi));
+      graph->remove(u);
+
+    // Each neighbor remaining gains source for every edge to the cut.
+    for (size_t i = neighborsBegin; i < touched.size(); ++i)
+      if (graph->alive(touched[i]))
+        graph->addSource(touched[i], (UnitFlow::Flow)ceil(2.0 / phi));
+    hasExcess = graph->resume(h, std::move(touched), heuristics);
   }
 
   VLOG(2) << "After trimming partition has " << graph->size() << " vertices.";
 }
+
+template class BasicSolver<int32_t>;
+template class BasicSolver<int64_t>;
 }; // namespace Trimming
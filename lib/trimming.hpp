@@ -6,17 +6,28 @@
 
 namespace Trimming {
 
-class Solver {
+/**
+   Trimming of a flow graph with vertex indices of type 'V'.
+ */
+template <typename V> class BasicSolver {
 private:
-  UnitFlow::Graph *graph;
+  UnitFlow::BasicGraph<V> *graph;
   const double phi;
+  const UnitFlow::Heuristics heuristics;
 
 public:
   /**
      Construct a trimming problem on the subgraph in 'g' induced by 'subset'.
+     Flow is computed using push-relabel 'heuristics'.
    */
-  Solver(UnitFlow::Graph *g, const double phi);
+  BasicSolver(UnitFlow::BasicGraph<V> *g, const double phi,
+              UnitFlow::Heuristics heuristics = {});
 
   void compute();
 };
+
+using Solver = BasicSolver<int>;
+
+extern template class BasicSolver<int32_t>;
+extern template class BasicSolver<int64_t>;
 }; // namespace Trimming
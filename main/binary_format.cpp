@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <glog/logging.h>
+#include <sstream>
+#include <vector>
+
+#include "binary_format.hpp"
+
+namespace BinaryFormat {
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+              "Binary graph format assumes a little-endian host.");
+
+bool matches(const char *begin, const char *end) {
+  return size_t(end - begin) >= sizeof(magic) &&
+         std::memcmp(begin, magic, sizeof(magic)) == 0;
+}
+
+uint64_t byteSize(const Header &header) {
+  return sizeof(Header) + sizeof(uint64_t) * (header.n + 1) +
+         sizeof(uint32_t) * 2 * header.m;
+}
+
+std::string tryParse(const char *begin, const char *end, View &view) {
+  const size_t size = size_t(end - begin);
+  if (size < sizeof(Header))
+    return "Binary graph is missing header.";
+  if (reinterpret_cast<uintptr_t>(begin) % alignof(uint64_t) != 0)
+    return "Binary graph is not aligned.";
+
+  const auto *header = reinterpret_cast<const Header *>(begin);
+  if (!matches(begin, end))
+    return "Binary graph has incorrect magic.";
+  if (header->version != version)
+    return "Unsupported binary graph version.";
+  if (header->flags != 0)
+    return "Unsupported binary graph flags.";
+
+  view.n = header->n;
+  view.m = header->m;
+  if (view.n > uint64_t(UINT32_MAX) + 1)
+    return "Too many vertices for 32-bit neighbors.";
+  // Bound 'm' by the size first such that 'byteSize' cannot overflow.
+  if (view.m > size / (2 * sizeof(uint32_t)) || size != byteSize(*header))
+    return "Binary graph has incorrect size.";
+
+  view.offsets = reinterpret_cast<const uint64_t *>(begin + sizeof(Header));
+  view.neighbors =
+      reinterpret_cast<const uint32_t *>(view.offsets + view.n + 1);
+
+  std::ostringstream error;
+  if (view.offsets[0] != 0)
+    return "First offset should be zero.";
+  if (view.offsets[view.n] != 2 * view.m)
+    return "Last offset should equal the number of edge endpoints.";
+
+  for (uint64_t u = 0; u < view.n; ++u)
+    if (view.offsets[u] > view.offsets[u + 1])
+      return "Offsets should be non-decreasing.";
+
+  // Make sure every adjacency list is sorted and every edge has a reverse, by
+  // pairing each '(u,v)' with 'u < v' against the next unpaired entry of 'v'.
+  std::vector<uint64_t> nextReverse(view.offsets, view.offsets + view.n);
+  for (uint64_t u = 0; u < view.n; ++u) {
+    for (uint64_t i = view.offsets[u]; i < view.offsets[u + 1]; ++i) {
+      const uint64_t v = view.neighbors[i];
+      if (v >= view.n)
+        return "Neighbor out of range.";
+      if (u == v)
+        return "Self-loops are not allowed.";
+      if (i != view.offsets[u] && view.neighbors[i - 1] >= v) {
+        error << "Adjacency list of " << u << " is not sorted.";
+        return error.str();
+      }
+      if (u < v && (nextReverse[v] == view.offsets[v + 1] ||
+                    view.neighbors[nextReverse[v]++] != u)) {
+        error << "Edge (" << u << ", " << v << ") has no reverse.";
+        return error.str();
+      }
+    }
+  }
+  for (uint64_t v = 0; v < view.n; ++v)
+    if (nextReverse[v] != view.offsets[v + 1] &&
+        view.neighbors[nextReverse[v]] < v) {
+      error << "Vertex " << v << " has an edge without a reverse.";
+      return error.str();
+    }
+
+  return "";
+}
+
+View parse(const char *begin, const char *end) {
+  View view;
+  const std::string error = tryParse(begin, end, view);
+  CHECK(error.empty()) << error;
+  return view;
+}
+
+void write(const std::string &path, const Undirected::Graph &g) {
+  const int n = g.size();
+
+  std::vector<uint64_t> offsets(n + 1, 0);
+  std::vector<uint32_t> neighbors;
+  for (int u = 0; u < n; ++u) {
+    const size_t start = neighbors.size();
+    for (auto e = g.cbeginEdge(u); e != g.cendEdge(u); ++e)
+      if (e->to != u)
+        neighbors.push_back(uint32_t(e->to));
+    std::sort(neighbors.begin() + start, neighbors.end());
+    offsets[u + 1] = neighbors.size();
+  }
+
+  write(path, uint64_t(n), offsets.data(), neighbors.data());
+}
+
+void write(const std::string &path, uint64_t n, const uint64_t *offsets,
+           const uint32_t *neighbors) {
+  Header header;
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.version = version;
+  header.flags = 0;
+  header.n = n;
+  header.m = offsets[n] / 2;
+
+  FILE *f = std::fopen(path.c_str(), "wb");
+  if (f == nullptr)
+    PLOG(FATAL) << "Could not open '" << path << "' for writing";
+
+  bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1;
+  ok = ok && std::fwrite(offsets, sizeof(uint64_t), n + 1, f) == n + 1;
+  ok = ok && std::fwrite(neighbors, sizeof(uint32_t), offsets[n], f) ==
+                 offsets[n];
+  ok = std::fclose(f) == 0 && ok;
+  if (!ok)
+    PLOG(FATAL) << "Could not write '" << path << "'";
+}
+
+} // namespace BinaryFormat
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "lib/datastructures/undirected_graph.hpp"
+
+/**
+   Versioned binary graph format storing adjacency as flat arrays, such that a
+   graph can be loaded by memory mapping the file without any tokenisation.
+
+   Layout, all values little-endian:
+   - Header (32 bytes): magic "EDCGRAPH", 32-bit version, 32-bit flags, 64-bit
+     number of vertices 'n' and 64-bit number of undirected edges 'm'.
+   - 'n + 1' 64-bit offsets into the neighbor array.
+   - '2m' 32-bit neighbors. The neighbors of 'u' are in range
+     '[offsets[u],offsets[u+1])', sorted, and each edge occurs in the adjacency
+     list of both its endpoints.
+ */
+namespace BinaryFormat {
+
+constexpr char magic[8] = {'E', 'D', 'C', 'G', 'R', 'A', 'P', 'H'};
+constexpr uint32_t version = 1;
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t flags;
+  uint64_t n;
+  uint64_t m;
+};
+static_assert(sizeof(Header) == 32, "Header should not contain padding.");
+
+/**
+   Arrays of a graph stored in the binary format. Pointers refer into the
+   memory the graph was parsed from.
+ */
+struct View {
+  uint64_t n, m;
+  const uint64_t *offsets;
+  const uint32_t *neighbors;
+};
+
+/**
+   True if '[begin,end)' starts with the binary format magic.
+ */
+bool matches(const char *begin, const char *end);
+
+/**
+   Validate the graph stored in '[begin,end)' and return views of its arrays.
+   '[begin,end)' must be aligned to 8 bytes. Terminates if the data is not a
+   valid graph of the current version.
+ */
+View parse(const char *begin, const char *end);
+
+/**
+   Like 'parse', but return a description of the problem instead of terminating
+   if the data is not a valid graph. Return an empty string if 'view' was set.
+ */
+std::string tryParse(const char *begin, const char *end, View &view);
+
+/**
+   Size in bytes of a graph in the binary format with the given header.
+ */
+uint64_t byteSize(const Header &header);
+
+/**
+   Write 'g' to the file at 'path' in the binary format. Self-loops are not
+   written since they do not affect the decomposition.
+ */
+void write(const std::string &path, const Undirected::Graph &g);
+
+/**
+   Write the graph with 'n' vertices given by an adjacency array to the file at
+   'path' in the binary format. Adjacency lists must be sorted without
+   duplicates or self-loops, as read by 'withAdjacency'.
+ */
+void write(const std::string &path, uint64_t n, const uint64_t *offsets,
+           const uint32_t *neighbors);
+
+} // namespace BinaryFormat
@@ -1,17 +1,24 @@
+#include <chrono>
 #include <cmath>
+#include <fstream>
 #include <gflags/gflags.h>
 #include <glog/logging.h>
 #include <glog/stl_logging.h>
 #include <iostream>
 #include <numeric>
+#include <sstream>
+#include <sys/resource.h>
 #include <vector>
 
 #include "lib/cut_matching.hpp"
 #include "lib/datastructures/undirected_graph.hpp"
 #include "lib/expander_decomp.hpp"
+#include "output.hpp"
+#include "reorder.hpp"
 #include "util.hpp"
 
 using namespace std;
+using Clock = chrono::steady_clock;
 
 DEFINE_uint32(seed, 0,
               "Seed randomness with any positive integer. Default value '0' "
@@ -33,14 +40,236 @@ DEFINE_double(
     min_balance, 0.45,
     "The amount of cut balance before the cut-matching game is terminated.");
 DEFINE_bool(chaco, false,
-            "Input graph is given in the Chaco graph file format");
+            "Input graph is given in the Chaco graph file format. Same as "
+            "'-format=chaco'.");
+DEFINE_string(format, "edgelist",
+              "Format of input graph: 'edgelist', 'chaco', 'metis', 'mtx' or "
+              "'snap'. Graphs in the binary format are detected "
+              "automatically.");
+DEFINE_string(input, "",
+              "Read graph from this file instead of standard input.");
+DEFINE_string(output, "",
+              "Write decomposition to this file instead of standard output.");
+DEFINE_string(output_format, "text",
+              "Format of output: 'text' or 'binary'. The binary format "
+              "contains the partition of each vertex and the conductance of "
+              "each partition as raw arrays, see 'Output::BinaryPartition'.");
 DEFINE_bool(partitions, false, "Output indices of partitions");
+DEFINE_string(reorder, "none",
+              "Relabel vertices before decomposing such that nearby vertices "
+              "are close in memory: 'none', 'bfs', 'rcm' or 'degree'. "
+              "Decompositions are written using the input labels.");
+DEFINE_string(batch, "",
+              "Decompose every graph listed in this manifest file. Each line "
+              "holds the path of a graph, optionally followed by a path its "
+              "decomposition is written to. Otherwise decompositions are "
+              "written to '-output' one after another.");
+DEFINE_double(extract_fraction, 0,
+              "Copy subproblems with fewer than this fraction of the vertices "
+              "of the graph they are part of into compact graphs before "
+              "decomposing them. '0' decomposes every subproblem in place.");
+DEFINE_bool(global_relabel, false,
+            "Periodically set heights to residual distances to a sink with a "
+            "reverse breadth-first search when trimming.");
+DEFINE_bool(gap_relabel, false,
+            "Lift vertices above a height with no vertices to the max height "
+            "when trimming.");
+DEFINE_bool(huge_pages, true,
+            "Advise the kernel to back large arrays of the flow graphs by "
+            "transparent huge pages.");
+DEFINE_bool(memstats, false,
+            "Write the memory used by each data structure of the solver and "
+            "the peak resident set size of the process to standard error at "
+            "the end of the run.");
 DEFINE_bool(sample_potential, false,
             "True if the potential function should be sampled.");
 DEFINE_bool(balanced_cut_strategy, true,
             "Propose perfectly balanced cuts in the cut-matching game. This "
             "results in faster convergance of the potential function.");
 
+/**
+   Milliseconds elapsed since 'start'.
+ */
+double millisecondsSince(Clock::time_point start) {
+  return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+/**
+   Push-relabel heuristics used when trimming, as given by flags.
+ */
+UnitFlow::Heuristics trimmingHeuristics() {
+  return {.globalRelabel = FLAGS_global_relabel, .gap = FLAGS_gap_relabel};
+}
+
+/**
+   Write the memory usage of 'solver' and the peak resident set size of the
+   process to standard error, if '-memstats' is given.
+ */
+template <typename V>
+void writeMemoryStats(const ExpanderDecomposition::BasicSolver<V> &solver) {
+  if (!FLAGS_memstats)
+    return;
+
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  cerr << "Memory usage of solver in bytes:\n"
+       << solver.memoryUsage() << "Peak resident set size in bytes: "
+       << uint64_t(usage.ru_maxrss) * 1024 << endl;
+}
+
+/**
+   Construct a graph with vertex indices of type 'V' from an adjacency array,
+   relabelling its vertices as given by '-reorder'. 'order[i]' is set to the
+   input vertex labelled 'i', or cleared if the input labels are kept.
+ */
+template <typename V>
+unique_ptr<Undirected::BasicGraph<V>>
+constructGraph(uint64_t n, const uint64_t *offsets, const uint32_t *neighbors,
+               vector<uint32_t> &order) {
+  if (FLAGS_reorder == "none") {
+    order.clear();
+    return make_unique<Undirected::BasicGraph<V>>(V(n), offsets, neighbors);
+  }
+
+  const auto start = Clock::now();
+  order = Reorder::order(FLAGS_reorder, n, offsets, neighbors);
+  const auto relabelled = Reorder::relabel(order, offsets, neighbors);
+  VLOG(1) << "Reordered vertices by '" << FLAGS_reorder << "' in "
+          << millisecondsSince(start) << " ms.";
+  return make_unique<Undirected::BasicGraph<V>>(
+      V(n), relabelled.offsets.data(), relabelled.neighbors.data());
+}
+
+/**
+   Write the decomposition computed by 'solver' as a single record in the
+   format given by '-output_format'. Vertices are mapped back to their input
+   labels using 'order', see 'constructGraph'.
+ */
+template <typename V>
+void writeDecomposition(Output::Writer &out,
+                        const ExpanderDecomposition::BasicSolver<V> &solver,
+                        const vector<uint32_t> &order) {
+  const auto conductances = solver.getConductance();
+  if (FLAGS_output_format == "text") {
+    auto partitions = solver.getPartition();
+    if (!order.empty())
+      for (auto &p : partitions)
+        for (auto &u : p)
+          u = V(order[u]);
+    Output::writeText(out, solver.getEdgesCut(), partitions, conductances,
+                      FLAGS_partitions);
+  } else if (FLAGS_output_format == "binary") {
+    if (order.empty()) {
+      Output::writeBinary(out, solver.getEdgesCut(), solver.getPartitionOf(),
+                          conductances);
+    } else {
+      const auto &relabelled = solver.getPartitionOf();
+      vector<V> partitionOf(relabelled.size());
+      for (size_t i = 0; i < relabelled.size(); ++i)
+        partitionOf[order[i]] = relabelled[i];
+      Output::writeBinary(out, solver.getEdgesCut(), partitionOf,
+                          conductances);
+    }
+  } else {
+    LOG(FATAL) << "Unknown output format '" << FLAGS_output_format << "'.";
+  }
+}
+
+/**
+   Decompose 'g' and write its decomposition to '-output'.
+ */
+template <typename V>
+void decomposeGraph(unique_ptr<Undirected::BasicGraph<V>> g,
+                    const vector<uint32_t> &order,
+                    const CutMatching::Parameters &params,
+                    std::mt19937 *randomGen) {
+  const auto start = Clock::now();
+  ExpanderDecomposition::BasicSolver<V> solver(move(g), FLAGS_phi, randomGen,
+                                               params, FLAGS_extract_fraction,
+                                               trimmingHeuristics());
+  VLOG(1) << "Decomposed graph in " << millisecondsSince(start) << " ms.";
+
+  Output::Writer out(FLAGS_output);
+  writeDecomposition(out, solver, order);
+  writeMemoryStats(solver);
+}
+
+/**
+   Decompose 'g' in batch mode and write its decomposition to 'out', or to the
+   file at 'output' if it is not empty. 'solver' is constructed on first use
+   and kept for later graphs with the same index type.
+ */
+template <typename V>
+void decomposeBatchGraph(
+    unique_ptr<ExpanderDecomposition::BasicSolver<V>> &solver,
+    unique_ptr<Undirected::BasicGraph<V>> g, const vector<uint32_t> &order,
+    const CutMatching::Parameters &params, std::mt19937 &randomGen,
+    Output::Writer &out, const string &output) {
+  if (!solver)
+    solver = make_unique<ExpanderDecomposition::BasicSolver<V>>(
+        FLAGS_phi, &randomGen, params, FLAGS_extract_fraction,
+        trimmingHeuristics());
+  solver->decompose(move(g));
+  if (output.empty()) {
+    writeDecomposition(out, *solver, order);
+  } else {
+    Output::Writer record(output);
+    writeDecomposition(record, *solver, order);
+  }
+}
+
+/**
+   Decompose each graph in the manifest at 'path', reusing storage between
+   graphs. As in single graph mode, graphs whose subdivision graph cannot be
+   indexed by 32 bits are decomposed by a solver with 64-bit indices, which is
+   kept next to the 32-bit one.
+ */
+void runBatch(const std::string &path, const CutMatching::Parameters &params,
+              std::mt19937 &randomGen) {
+  ifstream manifest(path);
+  CHECK(manifest) << "Could not open manifest '" << path << "'.";
+
+  unique_ptr<ExpanderDecomposition::BasicSolver<int32_t>> smallSolver;
+  unique_ptr<ExpanderDecomposition::BasicSolver<int64_t>> largeSolver;
+  Output::Writer out(FLAGS_output);
+  vector<uint32_t> order;
+  string line;
+  while (getline(manifest, line)) {
+    istringstream fields(line);
+    string input, output;
+    if (!(fields >> input) || input[0] == '#')
+      continue;
+    fields >> output;
+
+    // Reseed such that each graph is decomposed as if by a separate run.
+    randomGen = *configureRandomness(FLAGS_seed);
+
+    VLOG(1) << "Decomposing '" << input << "'.";
+    unique_ptr<Undirected::BasicGraph<int32_t>> small;
+    unique_ptr<Undirected::BasicGraph<int64_t>> large;
+    withAdjacency(FLAGS_chaco ? "chaco" : FLAGS_format, input,
+                  [&](uint64_t n, const uint64_t *offsets,
+                      const uint32_t *neighbors) {
+                    if (n + offsets[n] / 2 < uint64_t(INT32_MAX))
+                      small = constructGraph<int32_t>(n, offsets, neighbors,
+                                                      order);
+                    else
+                      large = constructGraph<int64_t>(n, offsets, neighbors,
+                                                      order);
+                  });
+    if (small)
+      decomposeBatchGraph(smallSolver, move(small), order, params, randomGen,
+                          out, output);
+    else
+      decomposeBatchGraph(largeSolver, move(large), order, params, randomGen,
+                          out, output);
+  }
+  if (smallSolver)
+    writeMemoryStats(*smallSolver);
+  if (largeSolver)
+    writeMemoryStats(*largeSolver);
+}
+
 int main(int argc, char *argv[]) {
   google::InitGoogleLogging(argv[0]);
 
@@ -48,10 +277,7 @@ int main(int argc, char *argv[]) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
 
   auto randomGen = configureRandomness(FLAGS_seed);
-
-  VLOG(1) << "Reading input.";
-  auto g = readGraph(FLAGS_chaco);
-  VLOG(1) << "Finished reading input.";
+  HugePages::enabled = FLAGS_huge_pages;
 
   const int default_t1 = FLAGS_balanced_cut_strategy ? 22 : 142;
   const double default_t2 = FLAGS_balanced_cut_strategy ? 5.0 : 17.2;
@@ -64,17 +290,31 @@ int main(int argc, char *argv[]) {
       .samplePotential = FLAGS_sample_potential,
       .balancedCutStrategy = FLAGS_balanced_cut_strategy};
 
-  ExpanderDecomposition::Solver solver(move(g), FLAGS_phi, randomGen.get(),
-                                       params);
-  auto partitions = solver.getPartition();
-  auto conductances = solver.getConductance();
-
-  cout << solver.getEdgesCut() << " " << partitions.size() << endl;
-  for (int i = 0; i < int(partitions.size()); ++i) {
-    cout << partitions[i].size() << " " << conductances[i];
-    if (FLAGS_partitions)
-      for (auto p : partitions[i])
-        cout << " " << p;
-    cout << endl;
+  if (!FLAGS_batch.empty()) {
+    runBatch(FLAGS_batch, params, *randomGen);
+    return 0;
   }
+
+  // The subdivision graph has a vertex for every vertex and edge of the
+  // input, so 64-bit indices are only used if 32-bit ones cannot index it.
+  VLOG(1) << "Reading input.";
+  unique_ptr<Undirected::BasicGraph<int32_t>> small;
+  unique_ptr<Undirected::BasicGraph<int64_t>> large;
+  vector<uint32_t> order;
+  withAdjacency(FLAGS_chaco ? "chaco" : FLAGS_format, FLAGS_input,
+                [&](uint64_t n, const uint64_t *offsets,
+                    const uint32_t *neighbors) {
+                  if (n + offsets[n] / 2 < uint64_t(INT32_MAX))
+                    small = constructGraph<int32_t>(n, offsets, neighbors,
+                                                    order);
+                  else
+                    large = constructGraph<int64_t>(n, offsets, neighbors,
+                                                    order);
+                });
+  VLOG(1) << "Finished reading input.";
+
+  if (small)
+    decomposeGraph(move(small), order, params, randomGen.get());
+  else
+    decomposeGraph(move(large), order, params, randomGen.get());
 }
@@ -0,0 +1,172 @@
+#include <chrono>
+#include <cstring>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "lib/datastructures/unit_flow.hpp"
+#include "util.hpp"
+
+using namespace std;
+
+DEFINE_bool(chaco, false,
+            "Input graph is given in the Chaco graph file format. Same as "
+            "'-format=chaco'.");
+DEFINE_string(format, "edgelist",
+              "Format of input graph: 'edgelist', 'chaco', 'metis', 'mtx' or "
+              "'snap'. Graphs in the binary format are detected "
+              "automatically.");
+DEFINE_string(input, "",
+              "Read graph from this file instead of standard input.");
+DEFINE_int32(repetitions, 3, "Number of times each operation is timed.");
+DEFINE_int32(height, 20,
+             "Maximum height used by push-relabel. The default is close to the "
+             "height used by the cut-matching game with phi = 0.01.");
+DEFINE_uint32(seed, 1, "Seed used to choose sources, sinks and subgraphs.");
+
+/**
+   Counter of data TLB misses of loads by this process, read using
+   'perf_event_open'. Unavailable if the kernel or hardware does not expose
+   the counter, e.g. in many virtual machines.
+ */
+class TlbMisses {
+private:
+  int fd = -1;
+
+public:
+  TlbMisses() {
+#if defined(__linux__)
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HW_CACHE;
+    attr.config = PERF_COUNT_HW_CACHE_DTLB |
+                  (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    fd = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#endif
+  }
+  ~TlbMisses() {
+#if defined(__linux__)
+    if (fd != -1)
+      close(fd);
+#endif
+  }
+
+  bool available() const { return fd != -1; }
+
+  /**
+     Number of misses since the counter was opened, or 0 if unavailable.
+   */
+  uint64_t read() const {
+    uint64_t count = 0;
+#if defined(__linux__)
+    if (fd != -1 && ::read(fd, &count, sizeof(count)) != sizeof(count))
+      count = 0;
+#endif
+    return count;
+  }
+};
+
+/**
+   Time the hot paths of a flow graph with adjacency storage 'A' and print the
+   mean time of each in milliseconds, and the mean number of data TLB misses
+   of push-relabel if available. Large arrays are placed on huge pages if
+   'hugePages' is true.
+ */
+template <template <typename, typename> class A>
+void benchmark(const string &name, bool hugePages, uint64_t n,
+               const uint64_t *offsets, const uint32_t *neighbors) {
+  using Graph = UnitFlow::BasicGraph<int, A>;
+  using Clock = chrono::steady_clock;
+
+  HugePages::enabled = hugePages;
+  const TlbMisses tlbMisses;
+  auto start = Clock::now();
+  Graph g(int(n), offsets, neighbors);
+  const double construct =
+      chrono::duration<double, milli>(Clock::now() - start).count();
+
+  mt19937 randomGen(FLAGS_seed);
+  vector<int> half;
+  for (int u = 0; u < int(n); ++u)
+    if (randomGen() % 2 == 0)
+      half.push_back(u);
+
+  double pushRelabel = 0, bfs = 0, subgraph = 0;
+  uint64_t pushRelabelTlbMisses = 0;
+  for (int r = 0; r < FLAGS_repetitions; ++r) {
+    // Route flow from half of the vertices to the other half, as done when
+    // matching in the cut-matching game.
+    g.reset();
+    for (auto u : g) {
+      for (auto e = g.beginEdge(u); e != g.endEdge(u); ++e)
+        e->capacity = 2;
+      if (randomGen() % 2 == 0)
+        g.addSource(u, g.degree(u));
+      else
+        g.addSink(u, g.degree(u));
+    }
+    start = Clock::now();
+    const uint64_t missesBefore = tlbMisses.read();
+    g.compute(FLAGS_height);
+    pushRelabelTlbMisses += tlbMisses.read() - missesBefore;
+    pushRelabel +=
+        chrono::duration<double, milli>(Clock::now() - start).count();
+
+    start = Clock::now();
+    const auto components = g.connectedComponents();
+    bfs += chrono::duration<double, milli>(Clock::now() - start).count();
+    CHECK(!components.empty() || n == 0);
+
+    start = Clock::now();
+    g.subgraph(half.begin(), half.end());
+    g.connectedComponents();
+    g.restoreSubgraph();
+    subgraph += chrono::duration<double, milli>(Clock::now() - start).count();
+  }
+
+  const double reps = double(max(1, FLAGS_repetitions));
+  cout << setw(10) << name << fixed << setprecision(2) << setw(14)
+       << construct << setw(14) << pushRelabel / reps << setw(14) << bfs / reps
+       << setw(14) << subgraph / reps << setw(14);
+  if (tlbMisses.available())
+    cout << uint64_t(double(pushRelabelTlbMisses) / reps) << endl;
+  else
+    cout << "-" << endl;
+}
+
+int main(int argc, char *argv[]) {
+  google::InitGoogleLogging(argv[0]);
+
+  gflags::SetUsageMessage(
+      "Compare adjacency storage and huge pages of flow graphs");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  withAdjacency(FLAGS_chaco ? "chaco" : FLAGS_format, FLAGS_input,
+                [](uint64_t n, const uint64_t *offsets,
+                   const uint32_t *neighbors) {
+                  cout << "n = " << n << ", m = " << offsets[n] / 2 << endl;
+                  cout << setw(10) << "storage" << setw(14) << "construct"
+                       << setw(14) << "push-relabel" << setw(14) << "bfs"
+                       << setw(14) << "subgraph" << setw(14) << "dTLB misses"
+                       << endl;
+                  benchmark<SubsetGraph::NestedAdjacency>(
+                      "nested", false, n, offsets, neighbors);
+                  benchmark<SubsetGraph::FlatAdjacency>("flat", false, n,
+                                                        offsets, neighbors);
+                  benchmark<SubsetGraph::FlatAdjacency>("flat-huge", true, n,
+                                                        offsets, neighbors);
+                });
+}
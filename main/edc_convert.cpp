@@ -0,0 +1,40 @@
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <string>
+
+#include "binary_format.hpp"
+#include "util.hpp"
+
+DEFINE_bool(chaco, false,
+            "Input graph is given in the Chaco graph file format. Same as "
+            "'-format=chaco'.");
+DEFINE_string(format, "edgelist",
+              "Format of input graph: 'edgelist', 'chaco', 'metis', 'mtx' or "
+              "'snap'. Graphs in the binary format are detected "
+              "automatically.");
+DEFINE_string(input, "",
+              "Read graph from this file instead of standard input.");
+DEFINE_string(output, "", "File to write the binary graph to.");
+
+int main(int argc, char *argv[]) {
+  google::InitGoogleLogging(argv[0]);
+
+  gflags::SetUsageMessage(
+      "Convert a graph to the binary graph format read by 'edc'");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  CHECK(!FLAGS_output.empty()) << "An output file must be given.";
+
+  // The adjacency arrays are written as read, without constructing a graph,
+  // such that graphs too large for 32-bit vertex indices can be converted.
+  VLOG(1) << "Reading input.";
+  withAdjacency(FLAGS_chaco ? "chaco" : FLAGS_format, FLAGS_input,
+                [](uint64_t n, const uint64_t *offsets,
+                   const uint32_t *neighbors) {
+                  VLOG(1) << "Finished reading input.";
+                  BinaryFormat::write(FLAGS_output, n, offsets, neighbors);
+                  VLOG(1) << "Wrote " << n << " vertices and "
+                          << offsets[n] / 2 << " edges to '" << FLAGS_output
+                          << "'.";
+                });
+}
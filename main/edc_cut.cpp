@@ -34,7 +34,12 @@ DEFINE_double(
     min_balance, 0.25,
     "The amount of cut balance before the cut-matching game is terminated.");
 DEFINE_bool(chaco, false,
-            "Input graph is given in the Chaco graph file format");
+            "Input graph is given in the Chaco graph file format. Same as "
+            "'-format=chaco'.");
+DEFINE_string(format, "edgelist",
+              "Format of input graph: 'edgelist', 'chaco', 'metis', 'mtx' or "
+              "'snap'. Graphs in the binary format are detected "
+              "automatically.");
 DEFINE_bool(sample_potential, false,
             "True if the potential function should be sampled.");
 DEFINE_bool(balanced_cut_strategy, true,
@@ -53,7 +58,7 @@ int main(int argc, char *argv[]) {
   auto randomGen = configureRandomness(FLAGS_seed);
 
   VLOG(1) << "Reading input.";
-  auto g = readGraph(FLAGS_chaco);
+  auto g = readGraph(FLAGS_chaco ? "chaco" : FLAGS_format);
   VLOG(1) << "Finished reading input.";
 
   const int default_t1 = FLAGS_balanced_cut_strategy ? 22 : 124;
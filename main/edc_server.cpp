@@ -0,0 +1,196 @@
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <gflags/gflags.h>
+#include <glog/logging.h>
+#include <mutex>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+#include "lib/expander_decomp.hpp"
+#include "output.hpp"
+#include "server.hpp"
+#include "util.hpp"
+
+using namespace std;
+using Server::Clock;
+
+DEFINE_string(socket, "/tmp/edc.sock",
+              "Path of the Unix domain socket to listen on for graphs.");
+DEFINE_string(stats_socket, "",
+              "Path of the Unix domain socket serving statistics. Defaults to "
+              "the path of '-socket' followed by '.stats'.");
+DEFINE_uint64(max_request_bytes, uint64_t(1) << 30,
+              "Close connections sending a graph larger than this many bytes "
+              "in the binary format, before memory for it is allocated.");
+DEFINE_int32(timeout_ms, 30000,
+             "Close connections on which reading a request or writing its "
+             "response makes no progress for this many milliseconds, failing "
+             "the request. Value '0' disables the timeout.");
+DEFINE_uint64(max_queued, 1024,
+              "Close new connections while this many connections are waiting "
+              "for a worker.");
+DEFINE_int32(threads, 0,
+             "Number of worker threads decomposing graphs. Default value '0' "
+             "means one per hardware thread.");
+DEFINE_uint32(seed, 0,
+              "Seed randomness with any positive integer. Default value '0' "
+              "means a random seed will be chosen based on system time.");
+DEFINE_double(
+    phi, 0.01,
+    "Value of \\phi such that expansion of each cluster is at least \\phi");
+DEFINE_int32(t1, -1,
+             "Constant 't1' in 'T = t1 + t2 \\log^2 m'. Will be chosen by "
+             "strategy if not chosen manually.");
+DEFINE_double(t2, -1.0,
+              "Constant 't2' in 'T = t1 + t2 \\log^2 m'. Will be chosen by "
+              "strategy if not chosen manually.");
+DEFINE_int32(
+    min_iterations, 0,
+    "Minimum iterations to run cut-matching game. If this is larger than 'T' "
+    "then certificate of expansion can be effected due to extra congestion.");
+DEFINE_double(
+    min_balance, 0.45,
+    "The amount of cut balance before the cut-matching game is terminated.");
+DEFINE_bool(balanced_cut_strategy, true,
+            "Propose perfectly balanced cuts in the cut-matching game. This "
+            "results in faster convergance of the potential function.");
+
+/**
+   Create a socket listening on 'path', replacing any existing socket file.
+ */
+int listenOn(const string &path) {
+  sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  CHECK_LT(path.size(), sizeof(address.sun_path))
+      << "Socket path '" << path << "' is too long.";
+  strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+
+  const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd == -1)
+    PLOG(FATAL) << "Could not create socket";
+  unlink(path.c_str());
+  if (::bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) ==
+      -1)
+    PLOG(FATAL) << "Could not bind socket '" << path << "'";
+  if (listen(fd, SOMAXCONN) == -1)
+    PLOG(FATAL) << "Could not listen on socket '" << path << "'";
+  return fd;
+}
+
+/**
+   Take connections from the queue and serve them, keeping a warm solver
+   between connections.
+ */
+void work(Server::State &server, const CutMatching::Parameters &params) {
+  const Server::Options options = {
+      .seed = FLAGS_seed,
+      .maxRequestBytes = FLAGS_max_request_bytes,
+      .timeout = chrono::milliseconds(max(FLAGS_timeout_ms, 0))};
+  mt19937 randomGen(chooseSeed(FLAGS_seed));
+  ExpanderDecomposition::Solver solver(FLAGS_phi, &randomGen, params);
+  vector<uint64_t> request;
+
+  while (true) {
+    Server::Connection connection;
+    {
+      unique_lock<mutex> guard(server.lock);
+      server.changed.wait(guard, [&server] { return !server.queue.empty(); });
+      connection = server.queue.front();
+      server.queue.pop_front();
+      server.active++;
+    }
+
+    Server::serve(server, connection, options, solver, randomGen, request);
+    close(connection.fd);
+
+    lock_guard<mutex> guard(server.lock);
+    server.active--;
+  }
+}
+
+/**
+   Write the current statistics as text to every client of the stats socket.
+ */
+void reportStats(Server::State &server, int listener) {
+  while (true) {
+    const int fd = accept(listener, nullptr, nullptr);
+    if (fd == -1)
+      continue;
+
+    auto milliseconds = [](Clock::duration d) {
+      return chrono::duration<double, milli>(d).count();
+    };
+    {
+      Output::Writer out(fd);
+      lock_guard<mutex> guard(server.lock);
+      out << "queued " << int(server.queue.size()) << '\n'
+          << "active " << server.active << '\n'
+          << "completed " << server.completed << '\n'
+          << "failed " << server.failed << '\n'
+          << "rejected " << server.rejected << '\n'
+          << "mean_latency_ms "
+          << (server.completed > 0
+                  ? milliseconds(server.totalLatency) /
+                        double(server.completed)
+                  : 0.0)
+          << '\n'
+          << "max_latency_ms " << milliseconds(server.maxLatency) << '\n';
+    }
+    close(fd);
+  }
+}
+
+int main(int argc, char *argv[]) {
+  google::InitGoogleLogging(argv[0]);
+
+  gflags::SetUsageMessage("Expander decomposition server");
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  // Clients closing their connection early should not terminate the server.
+  signal(SIGPIPE, SIG_IGN);
+
+  const int default_t1 = FLAGS_balanced_cut_strategy ? 22 : 142;
+  const double default_t2 = FLAGS_balanced_cut_strategy ? 5.0 : 17.2;
+
+  const CutMatching::Parameters params = {
+      .tConst = FLAGS_t1 < -0.5 ? default_t1 : FLAGS_t1,
+      .tFactor = FLAGS_t2 < -0.5 ? default_t2 : FLAGS_t2,
+      .minIterations = FLAGS_min_iterations,
+      .minBalance = FLAGS_min_balance,
+      .samplePotential = false,
+      .balancedCutStrategy = FLAGS_balanced_cut_strategy};
+
+  const string statsPath = FLAGS_stats_socket.empty()
+                               ? FLAGS_socket + ".stats"
+                               : FLAGS_stats_socket;
+  const int listener = listenOn(FLAGS_socket);
+  const int statsListener = listenOn(statsPath);
+
+  Server::State server;
+  const int threads =
+      FLAGS_threads > 0 ? FLAGS_threads
+                        : max(1, int(thread::hardware_concurrency()));
+  vector<thread> workers;
+  for (int i = 0; i < threads; ++i)
+    workers.emplace_back(work, ref(server), cref(params));
+  thread stats(reportStats, ref(server), statsListener);
+
+  LOG(INFO) << "Listening on '" << FLAGS_socket << "' with " << threads
+            << " workers. Statistics on '" << statsPath << "'.";
+
+  while (true) {
+    const int fd = accept(listener, nullptr, nullptr);
+    if (fd == -1) {
+      PLOG(WARNING) << "Could not accept connection";
+      continue;
+    }
+    if (!server.enqueue({fd, Clock::now()}, FLAGS_max_queued))
+      close(fd);
+  }
+}
@@ -0,0 +1,837 @@
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <lzma.h>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <zlib.h>
+
+#include "input.hpp"
+
+namespace Input {
+
+namespace {
+
+/**
+   Inputs are not split into chunks smaller than this, since the cost of
+   starting a thread would outweigh the parsing work.
+ */
+constexpr size_t minChunkSize = 1 << 20;
+
+/**
+   Size of the blocks produced when input is not memory mapped.
+ */
+constexpr size_t blockSize = 4 << 20;
+
+/**
+   Number of blocks in flight between the producer and the consumer. Bounds the
+   memory used for buffering regardless of the size of the input.
+ */
+constexpr int blockCount = 4;
+
+/**
+   Size of the buffer compressed input is read into.
+ */
+constexpr size_t compressedBlockSize = 1 << 20;
+
+/**
+   Arrays are not split into blocks with fewer elements than this when sorting.
+ */
+constexpr size_t minSortBlockSize = 1 << 16;
+
+/**
+   Number of bits sorted in each pass of the radix sort.
+ */
+constexpr int radixBits = 11;
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+enum class Codec { Identity, Gzip, Xz };
+
+/**
+   Detect the compression of input starting with the 'size' bytes at 'data'.
+ */
+Codec detectCodec(const char *data, size_t size) {
+  const auto *p = reinterpret_cast<const unsigned char *>(data);
+  if (size >= 2 && p[0] == 0x1f && p[1] == 0x8b)
+    return Codec::Gzip;
+  if (size >= 6 && std::memcmp(p, "\xfd" "7zXZ\0", 6) == 0)
+    return Codec::Xz;
+  return Codec::Identity;
+}
+
+/**
+   Read from 'fd' until 'size' bytes have been read or end of input is reached.
+   Return the number of bytes read.
+ */
+size_t readFully(int fd, char *data, size_t size) {
+  size_t total = 0;
+  while (total < size) {
+    const ssize_t count = read(fd, data + total, size - total);
+    if (count < 0 && errno == EINTR)
+      continue;
+    if (count < 0)
+      PLOG(FATAL) << "Could not read input";
+    if (count == 0)
+      break;
+    total += size_t(count);
+  }
+  return total;
+}
+
+/**
+   Run 'f(i)' for each 'i \in [0,k)' on its own thread and wait for all of them
+   to finish.
+ */
+template <typename F> void parallelFor(int k, F f) {
+  if (k == 1) {
+    f(0);
+    return;
+  }
+  std::vector<std::thread> threads;
+  threads.reserve(k);
+  for (int i = 0; i < k; ++i)
+    threads.emplace_back(f, i);
+  for (auto &t : threads)
+    t.join();
+}
+
+std::vector<std::pair<const char *, const char *>>
+chunks(const char *begin, const char *end, int threads) {
+  const size_t size = size_t(end - begin);
+  const int k = int(std::min(size_t(std::max(threads, 1)),
+                             size / minChunkSize + 1));
+  return splitLines(begin, end, k);
+}
+
+bool isComment(const char *it, const char *lineEnd, char comment) {
+  while (it != lineEnd && (*it == ' ' || *it == '\t'))
+    ++it;
+  return it != lineEnd && *it == comment;
+}
+
+/**
+   Parse edges from the complete lines '[begin,end)' using 'threads' threads
+   and append them to 'result'. 'line' is the index of the first adjacency line
+   in '[begin,end)'. Return the index of the line following it.
+ */
+size_t parseLines(const char *begin, const char *end, const LineFormat &format,
+                  size_t line, int threads, std::vector<int> &result) {
+  const auto cs = chunks(begin, end, threads);
+  const int k = int(cs.size());
+
+  // Lines of an adjacency list are vertices, so the index of the first line
+  // in each chunk is needed before the chunks can be parsed independently.
+  std::vector<size_t> firstLine(k + 1, line);
+  if (format.layout != LineFormat::Pairs) {
+    parallelFor(k, [&](int i) {
+      size_t count = 0;
+      for (auto [it, chunkEnd] = cs[i]; it != chunkEnd;) {
+        const char *lineEnd = it;
+        skipLine(lineEnd, chunkEnd);
+        if (!isComment(it, lineEnd, format.comment))
+          count++;
+        it = lineEnd;
+      }
+      firstLine[i + 1] = count;
+    });
+    for (int i = 0; i < k; ++i)
+      firstLine[i + 1] += firstLine[i];
+  }
+
+  std::vector<std::vector<int>> parts(k);
+  parallelFor(k, [&](int i) {
+    auto &part = parts[i];
+    size_t line = firstLine[i];
+    for (auto [it, chunkEnd] = cs[i]; it != chunkEnd;) {
+      const char *lineEnd = it;
+      skipLine(lineEnd, chunkEnd);
+      if (isComment(it, lineEnd, format.comment)) {
+        it = lineEnd;
+        continue;
+      }
+
+      if (format.layout == LineFormat::Pairs) {
+        int x;
+        while (nextInteger(it, lineEnd, x))
+          part.push_back(x - format.base);
+      } else if (format.layout == LineFormat::Edges) {
+        int u, v;
+        if (nextInteger(it, lineEnd, u) && nextInteger(it, lineEnd, v)) {
+          part.push_back(u - format.base);
+          part.push_back(v - format.base);
+        }
+      } else if (line < format.maxLines) {
+        const int u = int(line);
+        int x;
+        for (int j = 0; nextInteger(it, lineEnd, x); ++j) {
+          if (j < format.skip || (j - format.skip) % format.stride != 0)
+            continue;
+          if (const int v = x - format.base; u < v)
+            part.push_back(u), part.push_back(v);
+        }
+      }
+      line++;
+      it = lineEnd;
+    }
+  });
+
+  std::vector<size_t> start(k + 1, result.size());
+  for (int i = 0; i < k; ++i)
+    start[i + 1] = start[i] + parts[i].size();
+
+  result.resize(start[k]);
+  parallelFor(k, [&](int i) {
+    std::copy(parts[i].begin(), parts[i].end(), result.begin() + start[i]);
+    std::vector<int>().swap(parts[i]);
+  });
+
+  return firstLine[k];
+}
+
+/**
+   Return the first line of 'source' without consuming it.
+ */
+std::string peekLine(Source &source) {
+  while (!memchr(source.begin(), '\n', size_t(source.end() - source.begin())))
+    if (!source.fill())
+      break;
+  const char *lineEnd = source.begin();
+  skipLine(lineEnd, source.end());
+  return std::string(source.begin(), lineEnd);
+}
+
+} // namespace
+
+/**
+   Reads input from a file descriptor on a producer thread, decompressing it if
+   needed, and hands it over to the consumer in blocks. Only 'blockCount'
+   blocks exist, which are recycled by the consumer once copied.
+ */
+class Decoder {
+private:
+  int fd;
+  bool ownsFd;
+
+  std::mutex mutex;
+  std::condition_variable changed;
+
+  /**
+     Blocks which the producer may fill.
+   */
+  std::vector<std::vector<char>> freeBlocks;
+
+  /**
+     Filled blocks in input order, waiting for the consumer.
+   */
+  std::deque<std::vector<char>> readyBlocks;
+
+  /**
+     True when the producer has reached the end of input.
+   */
+  bool finished;
+
+  /**
+     True when the consumer is gone and the producer should stop.
+   */
+  bool stopped;
+
+  std::thread producer;
+
+  /**
+     Wait for a free block and move it into 'block' with size zero. Return
+     false if the producer should stop.
+   */
+  bool acquire(std::vector<char> &block) {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this] { return stopped || !freeBlocks.empty(); });
+    if (stopped)
+      return false;
+    block = std::move(freeBlocks.back());
+    freeBlocks.pop_back();
+    block.clear();
+    return true;
+  }
+
+  /**
+     Hand 'block' over to the consumer and acquire the next one.
+   */
+  bool publish(std::vector<char> &block) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      readyBlocks.push_back(std::move(block));
+    }
+    changed.notify_all();
+    return acquire(block);
+  }
+
+  void finish() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      finished = true;
+    }
+    changed.notify_all();
+  }
+
+  /**
+     Replace 'in' with the next compressed input. Return false at end of input.
+   */
+  bool refill(std::vector<char> &in) {
+    in.resize(compressedBlockSize);
+    in.resize(readFully(fd, in.data(), compressedBlockSize));
+    return !in.empty();
+  }
+
+  void copy(std::vector<char> &block) {
+    while (true) {
+      const size_t offset = block.size();
+      block.resize(blockSize);
+      block.resize(offset + readFully(fd, block.data() + offset,
+                                      blockSize - offset));
+      if (block.size() < blockSize)
+        break;
+      if (!publish(block))
+        return;
+    }
+    if (!block.empty())
+      publish(block);
+  }
+
+  void inflateGzip(std::vector<char> &block, std::vector<char> &in) {
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+    // Window bits '15 + 32' accepts both zlib and gzip headers.
+    CHECK_EQ(inflateInit2(&stream, 15 + 32), Z_OK)
+        << "Could not initialize gzip decoder.";
+
+    stream.next_in = reinterpret_cast<Bytef *>(in.data());
+    stream.avail_in = uInt(in.size());
+    bool inputEnded = false;
+    while (true) {
+      if (stream.avail_in == 0 && !inputEnded) {
+        inputEnded = !refill(in);
+        stream.next_in = reinterpret_cast<Bytef *>(in.data());
+        stream.avail_in = uInt(in.size());
+      }
+
+      const size_t offset = block.size();
+      block.resize(blockSize);
+      stream.next_out = reinterpret_cast<Bytef *>(block.data() + offset);
+      stream.avail_out = uInt(blockSize - offset);
+      const int status = inflate(&stream, Z_NO_FLUSH);
+      block.resize(blockSize - stream.avail_out);
+
+      if (status == Z_STREAM_END) {
+        // Concatenated gzip members decompress to the concatenated data.
+        if (stream.avail_in == 0 && !inputEnded) {
+          inputEnded = !refill(in);
+          stream.next_in = reinterpret_cast<Bytef *>(in.data());
+          stream.avail_in = uInt(in.size());
+        }
+        if (stream.avail_in == 0)
+          break;
+        inflateReset(&stream);
+      } else if (status == Z_BUF_ERROR && inputEnded) {
+        LOG(FATAL) << "Gzip input is truncated.";
+      } else if (status != Z_OK && status != Z_BUF_ERROR) {
+        LOG(FATAL) << "Could not decompress gzip input: "
+                   << (stream.msg ? stream.msg : "unknown error");
+      }
+
+      if (block.size() == blockSize && !publish(block)) {
+        inflateEnd(&stream);
+        return;
+      }
+    }
+    inflateEnd(&stream);
+    if (!block.empty())
+      publish(block);
+  }
+
+  void decodeXz(std::vector<char> &block, std::vector<char> &in) {
+    lzma_stream stream = LZMA_STREAM_INIT;
+    CHECK_EQ(lzma_stream_decoder(&stream, UINT64_MAX, LZMA_CONCATENATED),
+             LZMA_OK)
+        << "Could not initialize xz decoder.";
+
+    stream.next_in = reinterpret_cast<const uint8_t *>(in.data());
+    stream.avail_in = in.size();
+    lzma_action action = LZMA_RUN;
+    while (true) {
+      if (stream.avail_in == 0 && action == LZMA_RUN) {
+        if (!refill(in))
+          action = LZMA_FINISH;
+        stream.next_in = reinterpret_cast<const uint8_t *>(in.data());
+        stream.avail_in = in.size();
+      }
+
+      const size_t offset = block.size();
+      block.resize(blockSize);
+      stream.next_out = reinterpret_cast<uint8_t *>(block.data() + offset);
+      stream.avail_out = blockSize - offset;
+      const lzma_ret status = lzma_code(&stream, action);
+      block.resize(blockSize - stream.avail_out);
+
+      if (status == LZMA_STREAM_END)
+        break;
+      if (status != LZMA_OK)
+        LOG(FATAL) << "Could not decompress xz input (error " << status << ").";
+
+      if (block.size() == blockSize && !publish(block)) {
+        lzma_end(&stream);
+        return;
+      }
+    }
+    lzma_end(&stream);
+    if (!block.empty())
+      publish(block);
+  }
+
+  void run() {
+    std::vector<char> block;
+    if (!acquire(block))
+      return;
+
+    // Sniff the codec from the first bytes, which are kept as input to it.
+    std::vector<char> in;
+    refill(in);
+    switch (detectCodec(in.data(), in.size())) {
+    case Codec::Identity:
+      block.assign(in.begin(), in.end());
+      copy(block);
+      break;
+    case Codec::Gzip:
+      inflateGzip(block, in);
+      break;
+    case Codec::Xz:
+      decodeXz(block, in);
+      break;
+    }
+    finish();
+  }
+
+public:
+  Decoder(int fd, bool ownsFd)
+      : fd(fd), ownsFd(ownsFd), freeBlocks(blockCount), finished(false),
+        stopped(false) {
+    for (auto &block : freeBlocks)
+      block.reserve(blockSize);
+    producer = std::thread([this] { run(); });
+  }
+
+  ~Decoder() {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stopped = true;
+    }
+    changed.notify_all();
+    producer.join();
+    if (ownsFd)
+      close(fd);
+  }
+
+  /**
+     Wait for the next block and move it into 'block'. Return false if the
+     input is exhausted.
+   */
+  bool next(std::vector<char> &block) {
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this] { return finished || !readyBlocks.empty(); });
+    if (readyBlocks.empty())
+      return false;
+    block = std::move(readyBlocks.front());
+    readyBlocks.pop_front();
+    return true;
+  }
+
+  /**
+     Return a block obtained from 'next' to the producer.
+   */
+  void recycle(std::vector<char> &block) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      freeBlocks.push_back(std::move(block));
+    }
+    changed.notify_all();
+  }
+};
+
+Source::Source()
+    : windowBegin(nullptr), windowEnd(nullptr), mapping(nullptr),
+      mappingLength(0) {}
+
+std::unique_ptr<Source> Source::open(const std::string &path) {
+  std::unique_ptr<Source> source(new Source());
+
+  int fd = STDIN_FILENO;
+  if (!path.empty()) {
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+      PLOG(FATAL) << "Could not open '" << path << "'";
+  }
+
+  // Uncompressed regular files are mapped directly.
+  struct stat st;
+  if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+    char magic[6];
+    const ssize_t count = pread(fd, magic, sizeof(magic), 0);
+    if (count >= 0 && detectCodec(magic, size_t(count)) == Codec::Identity) {
+      void *p =
+          mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+      if (p != MAP_FAILED) {
+        madvise(p, size_t(st.st_size), MADV_WILLNEED);
+        source->mapping = p;
+        source->mappingLength = size_t(st.st_size);
+        source->windowBegin = static_cast<const char *>(p);
+        source->windowEnd = source->windowBegin + st.st_size;
+        if (fd != STDIN_FILENO)
+          close(fd);
+        return source;
+      }
+    }
+  }
+
+  source->decoder = std::make_unique<Decoder>(fd, fd != STDIN_FILENO);
+  return source;
+}
+
+Source::~Source() {
+  if (mapping != nullptr)
+    munmap(mapping, mappingLength);
+}
+
+bool Source::fill() {
+  std::vector<char> block;
+  if (decoder == nullptr || !decoder->next(block))
+    return false;
+
+  // Move the unconsumed input to the front before appending the block.
+  const size_t kept = size_t(windowEnd - windowBegin);
+  if (kept > 0 && windowBegin != window.data())
+    std::memmove(window.data(), windowBegin, kept);
+  window.resize(kept);
+  window.insert(window.end(), block.begin(), block.end());
+  decoder->recycle(block);
+
+  windowBegin = window.data();
+  windowEnd = windowBegin + window.size();
+  return true;
+}
+
+void Source::fill(size_t bytes) {
+  while (size_t(windowEnd - windowBegin) < bytes && fill())
+    ;
+}
+
+void Source::fillAll() {
+  while (fill())
+    ;
+}
+
+int defaultThreads() {
+  return std::max(1, int(std::thread::hardware_concurrency()));
+}
+
+std::vector<std::pair<const char *, const char *>>
+splitLines(const char *begin, const char *end, int k) {
+  std::vector<std::pair<const char *, const char *>> result;
+  if (begin == end)
+    return result;
+
+  const size_t target = std::max(size_t(1), size_t(end - begin) / size_t(k));
+  const char *it = begin;
+  while (it != end) {
+    const char *chunkEnd = it + std::min(target, size_t(end - it));
+    if (chunkEnd != end) {
+      const void *nl = memchr(chunkEnd, '\n', size_t(end - chunkEnd));
+      chunkEnd = nl ? static_cast<const char *>(nl) + 1 : end;
+    }
+    result.emplace_back(it, chunkEnd);
+    it = chunkEnd;
+  }
+  return result;
+}
+
+bool nextInteger(const char *&it, const char *end, int &value) {
+  bool negative = false;
+  while (it != end && !isDigit(*it))
+    negative = *it++ == '-';
+  if (it == end)
+    return false;
+
+  uint64_t x = 0;
+  while (it != end && isDigit(*it)) {
+    x = x * 10 + uint64_t(*it++ - '0');
+    CHECK_LE(x, uint64_t(INT32_MAX))
+        << "Integer in input is larger than " << INT32_MAX << ".";
+  }
+  CHECK(!negative) << "Integer -" << x << " in input is negative.";
+  value = int(x);
+  return true;
+}
+
+void skipLine(const char *&it, const char *end) {
+  const void *nl = memchr(it, '\n', size_t(end - it));
+  it = nl ? static_cast<const char *>(nl) + 1 : end;
+}
+
+std::vector<int> headerLine(Source &source, char comment) {
+  std::vector<int> values;
+  while (values.empty()) {
+    const char *it = source.begin(), *end = source.end();
+    const void *nl = memchr(it, '\n', size_t(end - it));
+    if (nl == nullptr && source.fill())
+      continue;
+    if (it == end)
+      break;
+
+    const char *lineEnd = nl ? static_cast<const char *>(nl) + 1 : end;
+    const char *first = it;
+    while (first != lineEnd && std::isspace(*first))
+      ++first;
+    if (first != lineEnd && *first != comment) {
+      int x;
+      while (nextInteger(first, lineEnd, x))
+        values.push_back(x);
+    }
+    source.consume(lineEnd);
+  }
+  return values;
+}
+
+std::vector<int> parseEdgeLines(Source &source, const LineFormat &format,
+                                int threads) {
+  std::vector<int> result;
+  size_t line = 0;
+  while (true) {
+    // Only complete lines are parsed, the remainder is kept for the next
+    // block.
+    const char *begin = source.begin(), *end = source.end();
+    const void *nl = memrchr(begin, '\n', size_t(end - begin));
+    const char *complete = nl ? static_cast<const char *>(nl) + 1 : begin;
+    line = parseLines(begin, complete, format, line, threads, result);
+    source.consume(complete);
+    if (!source.fill())
+      break;
+  }
+  parseLines(source.begin(), source.end(), format, line, threads, result);
+  source.consume(source.end());
+  return result;
+}
+
+int compactIds(std::vector<int> &ids, int threads) {
+  const size_t size = ids.size();
+  const int k = int(std::min(size_t(std::max(threads, 1)),
+                             size / minSortBlockSize + 1));
+  auto blockBegin = [size, k](int i) { return size * size_t(i) / size_t(k); };
+
+  int maxId = 0;
+  for (const int x : ids) {
+    CHECK_GE(x, 0) << "Vertex identifiers should be non-negative.";
+    maxId = std::max(maxId, x);
+  }
+
+  // Mark every identifier which occurs in a bitmap. The new identifier of 'x'
+  // is then the number of marked bits before it.
+  std::vector<uint64_t> occurs(size_t(maxId) / 64 + 1, 0);
+  for (const int x : ids)
+    occurs[size_t(x) / 64] |= uint64_t(1) << (x % 64);
+
+  std::vector<int> rank(occurs.size() + 1, 0);
+  for (size_t w = 0; w < occurs.size(); ++w)
+    rank[w + 1] = rank[w] + __builtin_popcountll(occurs[w]);
+
+  parallelFor(k, [&](int i) {
+    for (size_t j = blockBegin(i); j < blockBegin(i + 1); ++j) {
+      const int x = ids[j];
+      const uint64_t below = occurs[size_t(x) / 64] &
+                             ((uint64_t(1) << (x % 64)) - 1);
+      ids[j] = rank[size_t(x) / 64] + __builtin_popcountll(below);
+    }
+  });
+
+  return rank.back();
+}
+
+void radixSort(std::vector<uint64_t> &keys, int bits, int threads) {
+  constexpr size_t buckets = size_t(1) << radixBits;
+  const size_t size = keys.size();
+  const int k = int(std::min(size_t(std::max(threads, 1)),
+                             size / minSortBlockSize + 1));
+  auto blockBegin = [size, k](int i) { return size * size_t(i) / size_t(k); };
+
+  std::vector<uint64_t> sorted(size);
+  std::vector<size_t> count(size_t(k) * buckets);
+  for (int shift = 0; shift < bits; shift += radixBits) {
+    auto digit = [shift](uint64_t key) {
+      return size_t(key >> shift) & (buckets - 1);
+    };
+
+    std::fill(count.begin(), count.end(), 0);
+    parallelFor(k, [&](int i) {
+      size_t *c = count.data() + size_t(i) * buckets;
+      for (size_t j = blockBegin(i); j < blockBegin(i + 1); ++j)
+        c[digit(keys[j])]++;
+    });
+
+    // Blocks write to each bucket in order, which keeps the sort stable.
+    size_t sum = 0;
+    for (size_t d = 0; d < buckets; ++d)
+      for (int i = 0; i < k; ++i) {
+        const size_t c = count[size_t(i) * buckets + d];
+        count[size_t(i) * buckets + d] = sum;
+        sum += c;
+      }
+
+    parallelFor(k, [&](int i) {
+      size_t *c = count.data() + size_t(i) * buckets;
+      for (size_t j = blockBegin(i); j < blockBegin(i + 1); ++j)
+        sorted[c[digit(keys[j])]++] = keys[j];
+    });
+    keys.swap(sorted);
+  }
+}
+
+Adjacency fromEdgeList(int n, std::vector<int> &pairs, size_t m,
+                       int threads) {
+  CHECK_GE(pairs.size(), 2 * m) << "Expected " << m << " vertex pairs.";
+
+  int vertexBits = 1;
+  while (vertexBits < 31 && (1 << vertexBits) < n)
+    vertexBits++;
+  const uint64_t mask = (uint64_t(1) << vertexBits) - 1;
+
+  // Pack each edge as '(min(u,v), max(u,v))' into a single key.
+  std::vector<uint64_t> keys(m);
+  {
+    const int k = int(std::min(size_t(std::max(threads, 1)),
+                               m / minSortBlockSize + 1));
+    parallelFor(k, [&](int i) {
+      for (size_t j = m * size_t(i) / size_t(k);
+           j < m * size_t(i + 1) / size_t(k); ++j) {
+        uint64_t u = uint64_t(pairs[2 * j]), v = uint64_t(pairs[2 * j + 1]);
+        CHECK(u < uint64_t(n) && v < uint64_t(n))
+            << "Edge (" << u << ", " << v << ") out of range.";
+        if (u > v)
+          std::swap(u, v);
+        keys[j] = u << vertexBits | v;
+      }
+    });
+  }
+  std::vector<int>().swap(pairs);
+
+  radixSort(keys, 2 * vertexBits, threads);
+
+  // Single pass removing duplicates and self-loops.
+  size_t unique = 0;
+  for (size_t j = 0; j < keys.size(); ++j) {
+    const uint64_t key = keys[j];
+    if ((key >> vertexBits) != (key & mask) &&
+        (unique == 0 || keys[unique - 1] != key))
+      keys[unique++] = key;
+  }
+  keys.resize(unique);
+
+  Adjacency result;
+  result.offsets.assign(size_t(n) + 1, 0);
+  for (const auto key : keys) {
+    result.offsets[(key >> vertexBits) + 1]++;
+    result.offsets[(key & mask) + 1]++;
+  }
+  for (int u = 0; u < n; ++u)
+    result.offsets[u + 1] += result.offsets[u];
+
+  // Since keys are sorted, the smaller neighbors of each vertex are appended
+  // in increasing order before its larger neighbors, which are also in
+  // increasing order.
+  result.neighbors.resize(2 * keys.size());
+  std::vector<uint64_t> next(result.offsets.begin(), result.offsets.end() - 1);
+  for (const auto key : keys) {
+    const uint64_t u = key >> vertexBits, v = key & mask;
+    result.neighbors[next[u]++] = uint32_t(v);
+    result.neighbors[next[v]++] = uint32_t(u);
+  }
+
+  return result;
+}
+
+
+Adjacency readEdgeList(Source &source, int threads) {
+  const auto header = headerLine(source, '#');
+  CHECK_GE(header.size(), 2u)
+      << "Expected graph to start with number of vertices and edges.";
+
+  LineFormat format;
+  format.layout = LineFormat::Pairs;
+
+  auto pairs = parseEdgeLines(source, format, threads);
+  return fromEdgeList(header[0], pairs, size_t(header[1]), threads);
+}
+
+Adjacency readMetis(Source &source, int threads) {
+  const auto header = headerLine(source, '%');
+  CHECK_GE(header.size(), 2u)
+      << "Expected METIS header with number of vertices and edges.";
+
+  const int n = header[0];
+  const int fmt = header.size() > 2 ? header[2] : 0;
+  const bool edgeWeights = fmt % 10 != 0, vertexWeights = fmt / 10 % 10 != 0,
+             vertexSizes = fmt / 100 % 10 != 0;
+  const int constraints =
+      header.size() > 3 ? header[3] : (vertexWeights ? 1 : 0);
+
+  LineFormat format;
+  format.layout = LineFormat::Neighbors;
+  format.comment = '%';
+  format.skip = (vertexSizes ? 1 : 0) + (vertexWeights ? constraints : 0);
+  format.stride = edgeWeights ? 2 : 1;
+  format.base = 1;
+  format.maxLines = size_t(n);
+
+  auto pairs = parseEdgeLines(source, format, threads);
+  const size_t m = pairs.size() / 2;
+  return fromEdgeList(n, pairs, m, threads);
+}
+
+Adjacency readMatrixMarket(Source &source, int threads) {
+  const std::string banner = peekLine(source);
+  if (banner.rfind("%%MatrixMarket", 0) == 0) {
+    CHECK(banner.find("coordinate") != std::string::npos)
+        << "Only Matrix Market files in coordinate format are supported.";
+  }
+
+  const auto header = headerLine(source, '%');
+  CHECK_GE(header.size(), 3u)
+      << "Expected Matrix Market size line with rows, columns and entries.";
+  CHECK_EQ(header[0], header[1]) << "Expected a square matrix.";
+
+  LineFormat format;
+  format.layout = LineFormat::Edges;
+  format.comment = '%';
+  format.base = 1;
+
+  auto pairs = parseEdgeLines(source, format, threads);
+  const size_t m = pairs.size() / 2;
+  return fromEdgeList(header[0], pairs, m, threads);
+}
+
+Adjacency readSnap(Source &source, int threads) {
+  LineFormat format;
+  format.layout = LineFormat::Edges;
+  format.comment = '#';
+  format.base = 0;
+
+  auto pairs = parseEdgeLines(source, format, threads);
+  const int n = compactIds(pairs, threads);
+  const size_t m = pairs.size() / 2;
+  return fromEdgeList(n, pairs, m, threads);
+}
+
+} // namespace Input
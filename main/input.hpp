@@ -0,0 +1,238 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Input {
+
+class Decoder;
+
+/**
+   Input read as a sequence of blocks. Uncompressed regular files are memory
+   mapped and form a single block. Other inputs, such as pipes and gzip or xz
+   compressed files, are read and decompressed by a producer thread into
+   fixed-size blocks, which are handed over to the consumer while the producer
+   continues with the next block.
+
+   The consumer sees a window '[begin(),end())' of input which has been read
+   but not yet consumed.
+ */
+class Source {
+private:
+  /**
+     Current window of unconsumed input.
+   */
+  const char *windowBegin, *windowEnd;
+
+  /**
+     Non-null if the input is a memory mapping owned by this source.
+   */
+  void *mapping;
+
+  /**
+     Length of 'mapping' in bytes.
+   */
+  size_t mappingLength;
+
+  /**
+     Storage of the window when input is read in blocks. Unconsumed input is
+     kept at the front and new blocks are appended to it.
+   */
+  std::vector<char> window;
+
+  /**
+     Producer of blocks if input is not memory mapped.
+   */
+  std::unique_ptr<Decoder> decoder;
+
+  Source();
+
+public:
+  /**
+     Open the file at 'path'. If 'path' is empty, standard input is used.
+     Compressed input is detected from its magic bytes.
+   */
+  static std::unique_ptr<Source> open(const std::string &path);
+
+  ~Source();
+
+  Source(const Source &) = delete;
+  Source &operator=(const Source &) = delete;
+
+  const char *begin() const { return windowBegin; }
+  const char *end() const { return windowEnd; }
+
+  /**
+     Discard all input before 'it', which must be inside the window.
+   */
+  void consume(const char *it) { windowBegin = it; }
+
+  /**
+     Append the next block of input to the window. Return false, leaving the
+     window unchanged, if the input is exhausted.
+   */
+  bool fill();
+
+  /**
+     Fill the window until it contains at least 'bytes' bytes or the input is
+     exhausted.
+   */
+  void fill(size_t bytes);
+
+  /**
+     Fill the window with all remaining input.
+   */
+  void fillAll();
+};
+
+/**
+   Describes how edges are given by the lines of a text graph format.
+ */
+struct LineFormat {
+  /**
+     Ways edges can be laid out:
+     - Pairs: Every two consecutive integers form an edge, regardless of lines.
+     - Edges: Each line is a single edge given by its first two integers. Any
+       further values on the line are ignored.
+     - Neighbors: The i'th line lists the neighbors of vertex 'i' as in the
+       METIS format.
+   */
+  enum Layout { Pairs, Edges, Neighbors };
+
+  Layout layout = Pairs;
+
+  /**
+     Lines whose first non-blank character is 'comment' are skipped entirely.
+   */
+  char comment = '#';
+
+  /**
+     Number of integers at the start of an adjacency line which are not
+     neighbors, e.g. vertex sizes and weights.
+   */
+  int skip = 0;
+
+  /**
+     Number of integers per neighbor in an adjacency line. Only the first is
+     the neighbor, the remaining ones are e.g. edge weights.
+   */
+  int stride = 1;
+
+  /**
+     Index of the first vertex, subtracted from every vertex read.
+   */
+  int base = 0;
+
+  /**
+     Adjacency lines after the first 'maxLines' are ignored.
+   */
+  size_t maxLines = SIZE_MAX;
+};
+
+/**
+   Adjacency array of an undirected graph. The neighbors of 'u' are
+   '{neighbors[i] | i \in [offsets[u],offsets[u+1])}', sorted in increasing
+   order.
+ */
+struct Adjacency {
+  std::vector<uint64_t> offsets;
+  std::vector<uint32_t> neighbors;
+};
+
+/**
+   Number of threads to use when parsing. Equal to the hardware concurrency.
+ */
+int defaultThreads();
+
+/**
+   Split '[begin,end)' into at most 'k' consecutive non-empty chunks of roughly
+   equal size. Every chunk except the last ends directly after a newline, so no
+   line is shared between two chunks.
+ */
+std::vector<std::pair<const char *, const char *>>
+splitLines(const char *begin, const char *end, int k);
+
+/**
+   Parse the next non-negative integer in '[it,end)' and advance 'it' past it.
+   Characters which are not digits are treated as separators, except that a
+   '-' directly before the integer terminates since identifiers and counts are
+   never negative. Return false if there are no integers left. Terminates if
+   the integer does not fit in an 'int'.
+ */
+bool nextInteger(const char *&it, const char *end, int &value);
+
+/**
+   Advance 'it' past the next newline, or to 'end' if there is none.
+ */
+void skipLine(const char *&it, const char *end);
+
+/**
+   Return the integers on the first line of 'source' which is neither blank nor
+   a comment, and consume input up to and including that line.
+ */
+std::vector<int> headerLine(Source &source, char comment);
+
+/**
+   Parse edges from the lines of 'source' until it is exhausted. Each block of
+   complete lines is parsed using 'threads' threads while the next block is
+   being read. Return edges as vertex pairs in the order they appear in the
+   input. For adjacency lines, only pairs '(u,v)' with 'u < v' are returned
+   since every edge is expected to be listed by both its endpoints.
+ */
+std::vector<int> parseEdgeLines(Source &source, const LineFormat &format,
+                                int threads);
+
+/**
+   Relabel non-negative identifiers to the range '[0,k)' where 'k' is the number
+   of distinct identifiers, preserving their relative order. Return 'k'.
+ */
+int compactIds(std::vector<int> &ids, int threads);
+
+/**
+   Sort 'keys' in increasing order using a parallel LSD radix sort. Only the
+   lowest 'bits' bits of each key are considered.
+ */
+void radixSort(std::vector<uint64_t> &keys, int bits, int threads);
+
+/**
+   Construct the adjacency array of an undirected graph with 'n' vertices and
+   edges '{(pairs[2i],pairs[2i+1]) | i \in [0,m)}'. Duplicate edges and
+   self-loops are removed by radix sorting the edges as packed 64-bit keys
+   followed by a single pass over the sorted keys. Adjacency lists are sorted,
+   regardless of the order of 'pairs'. 'pairs' is released early to keep peak
+   memory close to the size of the result.
+ */
+Adjacency fromEdgeList(int n, std::vector<int> &pairs, size_t m, int threads);
+
+/**
+   Read a graph given as a line with the number of vertices 'n' and edges 'm',
+   followed by 'm' 0-indexed vertex pairs.
+ */
+Adjacency readEdgeList(Source &source, int threads);
+
+/**
+   Read a graph in the METIS format, which extends the Chaco format. The header
+   may specify vertex sizes, vertex weights and edge weights, which are
+   ignored. Lines starting with '%' are comments.
+ */
+Adjacency readMetis(Source &source, int threads);
+
+/**
+   Read a square sparse matrix in the Matrix Market coordinate format as an
+   undirected graph. Each non-zero entry '(i,j)' is an edge and values are
+   ignored.
+ */
+Adjacency readMatrixMarket(Source &source, int threads);
+
+/**
+   Read a SNAP edge list. Each line is an edge between two arbitrary
+   non-negative vertex identifiers, which are relabelled to '[0,n)' in
+   increasing order. Lines starting with '#' are comments.
+ */
+Adjacency readSnap(Source &source, int threads);
+
+} // namespace Input
@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <unistd.h>
+
+#include "output.hpp"
+
+namespace Output {
+
+namespace {
+
+/**
+   Size of the output buffer.
+ */
+constexpr size_t bufferSize = 1 << 20;
+
+} // namespace
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__,
+              "Binary partition format assumes a little-endian host.");
+
+Writer::Writer(const std::string &path)
+    : fd(STDOUT_FILENO), ownsFd(!path.empty()), fatal(true), failed(false) {
+  if (ownsFd) {
+    fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1)
+      PLOG(FATAL) << "Could not open '" << path << "' for writing";
+  }
+  buffer.reserve(bufferSize);
+}
+
+Writer::Writer(int fd) : fd(fd), ownsFd(false), fatal(false), failed(false) {
+  buffer.reserve(bufferSize);
+}
+
+Writer::~Writer() {
+  flush();
+  if (ownsFd && close(fd) != 0)
+    PLOG(FATAL) << "Could not write output";
+}
+
+void Writer::reserve(size_t bytes) {
+  if (buffer.size() + bytes > bufferSize)
+    flush();
+}
+
+void Writer::writeAll(const char *data, size_t bytes) {
+  while (bytes > 0 && !failed) {
+    const ssize_t count = ::write(fd, data, bytes);
+    if (count < 0 && errno == EINTR)
+      continue;
+    if (count < 0 && fatal)
+      PLOG(FATAL) << "Could not write output";
+    if (count < 0)
+      failed = true;
+    else
+      data += count, bytes -= size_t(count);
+  }
+}
+
+void Writer::write(const void *data, size_t bytes) {
+  if (bytes >= bufferSize) {
+    flush();
+    writeAll(static_cast<const char *>(data), bytes);
+    return;
+  }
+  reserve(bytes);
+  const char *p = static_cast<const char *>(data);
+  buffer.insert(buffer.end(), p, p + bytes);
+}
+
+Writer &Writer::operator<<(char c) {
+  reserve(1);
+  buffer.push_back(c);
+  return *this;
+}
+
+Writer &Writer::operator<<(const char *s) {
+  write(s, std::strlen(s));
+  return *this;
+}
+
+Writer &Writer::operator<<(long long x) {
+  char digits[24];
+  const auto result = std::to_chars(digits, digits + sizeof(digits), x);
+  write(digits, size_t(result.ptr - digits));
+  return *this;
+}
+
+Writer &Writer::operator<<(double x) {
+  char digits[32];
+  const int length = std::snprintf(digits, sizeof(digits), "%g", x);
+  write(digits, size_t(length));
+  return *this;
+}
+
+void Writer::flush() {
+  writeAll(buffer.data(), buffer.size());
+  buffer.clear();
+}
+
+template <typename V>
+void writeText(Writer &out, long long edgesCut,
+               const std::vector<std::vector<V>> &partitions,
+               const std::vector<double> &conductances, bool vertices) {
+  out << edgesCut << ' ' << (long long)partitions.size() << '\n';
+  for (size_t i = 0; i < partitions.size(); ++i) {
+    out << (long long)partitions[i].size() << ' ' << conductances[i];
+    if (vertices)
+      for (const V u : partitions[i])
+        out << ' ' << (long long)u;
+    out << '\n';
+  }
+}
+
+template <typename V>
+void writeBinary(Writer &out, long long edgesCut,
+                 const std::vector<V> &partitionOf,
+                 const std::vector<double> &conductances) {
+  using namespace BinaryPartition;
+
+  CHECK_LE(conductances.size(), size_t(INT32_MAX))
+      << "Too many partitions for 32-bit partition indices.";
+
+  Header header;
+  std::memcpy(header.magic, magic, sizeof(magic));
+  header.version = version;
+  header.flags = 0;
+  header.n = partitionOf.size();
+  header.k = conductances.size();
+  header.edgesCut = uint64_t(edgesCut);
+  out.write(&header, sizeof(header));
+
+  if constexpr (sizeof(V) == sizeof(int32_t)) {
+    out.write(partitionOf.data(), sizeof(int32_t) * partitionOf.size());
+  } else {
+    // Narrow indices in chunks to avoid a copy of the whole vector.
+    int32_t chunk[4096];
+    for (size_t i = 0; i < partitionOf.size(); i += 4096) {
+      const size_t count = std::min<size_t>(4096, partitionOf.size() - i);
+      for (size_t j = 0; j < count; ++j)
+        chunk[j] = int32_t(partitionOf[i + j]);
+      out.write(chunk, sizeof(int32_t) * count);
+    }
+  }
+  const uint64_t zero = 0;
+  out.write(&zero, sizeof(int32_t) * (partitionOf.size() % 2));
+  out.write(conductances.data(), sizeof(double) * conductances.size());
+}
+
+template void writeText(Writer &, long long,
+                        const std::vector<std::vector<int32_t>> &,
+                        const std::vector<double> &, bool);
+template void writeText(Writer &, long long,
+                        const std::vector<std::vector<int64_t>> &,
+                        const std::vector<double> &, bool);
+template void writeBinary(Writer &, long long, const std::vector<int32_t> &,
+                          const std::vector<double> &);
+template void writeBinary(Writer &, long long, const std::vector<int64_t> &,
+                          const std::vector<double> &);
+
+} // namespace Output
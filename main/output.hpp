@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Output {
+
+/**
+   Buffered writer to a file or standard output. Output is only written when
+   the buffer is full, when 'flush' is called or when the writer is destroyed.
+ */
+class Writer {
+private:
+  int fd;
+  bool ownsFd;
+  std::vector<char> buffer;
+
+  /**
+     True if write errors terminate the program. Otherwise 'failed' is set and
+     further output is discarded.
+   */
+  bool fatal;
+  bool failed;
+
+  /**
+     Write '[data,data+bytes)' directly to 'fd'.
+   */
+  void writeAll(const char *data, size_t bytes);
+
+  /**
+     Make room for at least 'bytes' bytes in the buffer.
+   */
+  void reserve(size_t bytes);
+
+public:
+  /**
+     Write to the file at 'path', or to standard output if 'path' is empty.
+   */
+  explicit Writer(const std::string &path = "");
+
+  /**
+     Write to the open file descriptor 'fd', e.g. a socket, which is not closed
+     by the writer. Write errors are not fatal, see 'good'.
+   */
+  explicit Writer(int fd);
+
+  ~Writer();
+
+  Writer(const Writer &) = delete;
+  Writer &operator=(const Writer &) = delete;
+
+  /**
+     Write 'bytes' raw bytes starting at 'data'.
+   */
+  void write(const void *data, size_t bytes);
+
+  Writer &operator<<(char c);
+  Writer &operator<<(const char *s);
+  Writer &operator<<(long long x);
+  Writer &operator<<(int x) { return *this << (long long)x; }
+
+  /**
+     Doubles are formatted as by 'std::ostream' with default precision.
+   */
+  Writer &operator<<(double x);
+
+  /**
+     Write all buffered output.
+   */
+  void flush();
+
+  /**
+     False if a write error has occurred.
+   */
+  bool good() const { return !failed; }
+};
+
+/**
+   Binary format of a decomposition, such that membership can be loaded by
+   memory mapping the file.
+
+   Layout, all values little-endian:
+   - Header (40 bytes): magic "EDCPARTS", 32-bit version, 32-bit flags, 64-bit
+     number of vertices 'n', 64-bit number of partitions 'k' and 64-bit number
+     of edges cut.
+   - 'n' 32-bit partition indices, where the i'th is the partition of vertex
+     'i'.
+   - Padding to a multiple of 8 bytes.
+   - 'k' 64-bit doubles, where the i'th is a lower bound on the conductance of
+     partition 'i'.
+ */
+namespace BinaryPartition {
+
+constexpr char magic[8] = {'E', 'D', 'C', 'P', 'A', 'R', 'T', 'S'};
+constexpr uint32_t version = 1;
+
+struct Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t flags;
+  uint64_t n;
+  uint64_t k;
+  uint64_t edgesCut;
+};
+static_assert(sizeof(Header) == 40, "Header should not contain padding.");
+
+} // namespace BinaryPartition
+
+/**
+   Write a decomposition as text. The first line contains the number of edges
+   cut and the number of partitions. Then follows a line for each partition
+   with its size and conductance and, if 'vertices' is true, its vertices.
+   Instantiated for 32-bit and 64-bit vertex indices 'V'.
+ */
+template <typename V>
+void writeText(Writer &out, long long edgesCut,
+               const std::vector<std::vector<V>> &partitions,
+               const std::vector<double> &conductances, bool vertices);
+
+/**
+   Write a decomposition in the binary format, see 'BinaryPartition'.
+   Partition indices are always written with 32 bits.
+ */
+template <typename V>
+void writeBinary(Writer &out, long long edgesCut,
+                 const std::vector<V> &partitionOf,
+                 const std::vector<double> &conductances);
+
+} // namespace Output
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <glog/logging.h>
+#include <numeric>
+
+#include "reorder.hpp"
+
+namespace Reorder {
+
+namespace {
+
+/**
+   Append the vertices reachable from 'start' which are not yet 'visited' to
+   'result' in breadth first order. If 'byDegree' is true, the neighbors of
+   each vertex are visited by increasing degree.
+ */
+void search(uint32_t start, const uint64_t *offsets, const uint32_t *neighbors,
+            bool byDegree, std::vector<char> &visited,
+            std::vector<uint32_t> &result) {
+  auto degree = [offsets](uint32_t u) { return offsets[u + 1] - offsets[u]; };
+
+  size_t head = result.size();
+  result.push_back(start), visited[start] = true;
+  while (head < result.size()) {
+    const uint32_t u = result[head++];
+    const size_t tail = result.size();
+    for (uint64_t i = offsets[u]; i < offsets[u + 1]; ++i)
+      if (!visited[neighbors[i]])
+        result.push_back(neighbors[i]), visited[neighbors[i]] = true;
+    if (byDegree)
+      std::stable_sort(result.begin() + tail, result.end(),
+                       [&degree](uint32_t v, uint32_t w) {
+                         return degree(v) < degree(w);
+                       });
+  }
+}
+
+} // namespace
+
+std::vector<uint32_t> order(const std::string &method, uint64_t n,
+                            const uint64_t *offsets,
+                            const uint32_t *neighbors) {
+  std::vector<uint32_t> result;
+  result.reserve(n);
+  std::vector<uint32_t> starts(n);
+  std::iota(starts.begin(), starts.end(), 0);
+  auto degree = [offsets](uint32_t u) { return offsets[u + 1] - offsets[u]; };
+
+  if (method == "bfs" || method == "rcm") {
+    const bool rcm = method == "rcm";
+    if (rcm)
+      std::stable_sort(starts.begin(), starts.end(),
+                       [&degree](uint32_t u, uint32_t v) {
+                         return degree(u) < degree(v);
+                       });
+    std::vector<char> visited(n, false);
+    for (const uint32_t u : starts)
+      if (!visited[u])
+        search(u, offsets, neighbors, rcm, visited, result);
+    if (rcm)
+      std::reverse(result.begin(), result.end());
+  } else if (method == "degree") {
+    result = std::move(starts);
+    std::stable_sort(result.begin(), result.end(),
+                     [&degree](uint32_t u, uint32_t v) {
+                       return degree(u) > degree(v);
+                     });
+  } else {
+    LOG(FATAL) << "Unknown reordering '" << method << "'.";
+  }
+
+  return result;
+}
+
+Input::Adjacency relabel(const std::vector<uint32_t> &order,
+                         const uint64_t *offsets, const uint32_t *neighbors) {
+  const size_t n = order.size();
+  std::vector<uint32_t> label(n);
+  for (size_t i = 0; i < n; ++i)
+    label[order[i]] = uint32_t(i);
+
+  Input::Adjacency result;
+  result.offsets.resize(n + 1);
+  result.offsets[0] = 0;
+  for (size_t i = 0; i < n; ++i)
+    result.offsets[i + 1] =
+        result.offsets[i] + offsets[order[i] + 1] - offsets[order[i]];
+
+  result.neighbors.resize(result.offsets[n]);
+  for (size_t i = 0; i < n; ++i) {
+    const uint32_t u = order[i];
+    uint32_t *list = result.neighbors.data() + result.offsets[i];
+    for (uint64_t j = offsets[u]; j < offsets[u + 1]; ++j)
+      list[j - offsets[u]] = label[neighbors[j]];
+    std::sort(list, result.neighbors.data() + result.offsets[i + 1]);
+  }
+
+  return result;
+}
+
+} // namespace Reorder
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "input.hpp"
+
+/**
+   Relabelling of vertices such that vertices which are close in the graph get
+   close labels. Adjacency lists of consecutive vertices then share cache lines
+   when searched, which helps inputs whose labels are essentially random.
+ */
+namespace Reorder {
+
+/**
+   Compute an order of the 'n' vertices of the adjacency array '(offsets,
+   neighbors)', where 'order[i]' is the vertex given label 'i'. 'method' is
+   one of:
+   - "bfs": Breadth first search order, starting each component at its
+     vertex with the smallest label.
+   - "rcm": Reverse Cuthill-McKee order, starting each component at a vertex
+     of minimum degree and visiting neighbors by increasing degree.
+   - "degree": Decreasing degree, such that high degree vertices are adjacent
+     in memory.
+ */
+std::vector<uint32_t> order(const std::string &method, uint64_t n,
+                            const uint64_t *offsets,
+                            const uint32_t *neighbors);
+
+/**
+   Return the adjacency array where vertex 'order[i]' is relabelled to 'i'.
+   Adjacency lists are sorted.
+ */
+Input::Adjacency relabel(const std::vector<uint32_t> &order,
+                         const uint64_t *offsets, const uint32_t *neighbors);
+
+} // namespace Reorder
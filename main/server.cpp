@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <glog/logging.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "binary_format.hpp"
+#include "output.hpp"
+#include "server.hpp"
+#include "util.hpp"
+
+namespace Server {
+
+namespace {
+
+/**
+   Read exactly 'bytes' bytes from 'fd'. Return the number of bytes read, which
+   is less than 'bytes' only if the connection was closed, failed or timed out.
+   'timedOut' is set in the last case.
+ */
+size_t readAll(int fd, char *data, size_t bytes, bool &timedOut) {
+  size_t total = 0;
+  timedOut = false;
+  while (total < bytes) {
+    const ssize_t count = read(fd, data + total, bytes - total);
+    if (count < 0 && errno == EINTR)
+      continue;
+    if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      timedOut = true;
+    if (count <= 0)
+      break;
+    total += size_t(count);
+  }
+  return total;
+}
+
+/**
+   Make reads and writes on the socket 'fd' fail once they have made no
+   progress for 'timeout'.
+ */
+void setTimeout(int fd, Clock::duration timeout) {
+  const auto us =
+      std::chrono::duration_cast<std::chrono::microseconds>(timeout).count();
+  timeval tv;
+  tv.tv_sec = time_t(us / 1'000'000);
+  tv.tv_usec = suseconds_t(us % 1'000'000);
+  if (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv)) == -1 ||
+      setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv)) == -1)
+    PLOG(WARNING) << "Could not set connection timeout";
+}
+
+} // namespace
+
+void State::finished(bool ok, Clock::duration latency) {
+  std::lock_guard<std::mutex> guard(lock);
+  if (!ok) {
+    failed++;
+    return;
+  }
+  completed++;
+  totalLatency += latency;
+  maxLatency = std::max(maxLatency, latency);
+}
+
+bool State::enqueue(const Connection &connection, size_t maxQueued) {
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    if (queue.size() >= maxQueued) {
+      rejected++;
+      return false;
+    }
+    queue.push_back(connection);
+  }
+  changed.notify_one();
+  return true;
+}
+
+void serve(State &state, const Connection &connection, const Options &options,
+           ExpanderDecomposition::Solver &solver, std::mt19937 &randomGen,
+           std::vector<uint64_t> &request) {
+  if (options.timeout > Clock::duration::zero())
+    setTimeout(connection.fd, options.timeout);
+
+  Clock::time_point arrived = connection.accepted;
+  while (true) {
+    BinaryFormat::Header header;
+    bool timedOut;
+    const size_t headerBytes =
+        readAll(connection.fd, reinterpret_cast<char *>(&header),
+                sizeof(header), timedOut);
+    // Clients may close their connection, or leave it idle until it times
+    // out, once their last request has been answered.
+    if (headerBytes == 0 && (!timedOut || arrived == Clock::time_point()))
+      return;
+    if (timedOut) {
+      LOG(WARNING) << "Closing connection after request timed out.";
+      state.finished(false, {});
+      return;
+    }
+    // The first request arrived when the connection was accepted, later ones
+    // when their header is read.
+    if (arrived == Clock::time_point())
+      arrived = Clock::now();
+
+    const char *begin = reinterpret_cast<const char *>(&header);
+    if (headerBytes < sizeof(header) ||
+        !BinaryFormat::matches(begin, begin + sizeof(header))) {
+      LOG(WARNING) << "Closing connection after invalid request header.";
+      state.finished(false, {});
+      return;
+    }
+    // The subdivision graph of the solver has a vertex for every vertex and
+    // edge of the graph, which must fit in 32 bits.
+    if (header.n >= uint64_t(INT32_MAX) || header.m >= uint64_t(INT32_MAX) ||
+        header.n + header.m >= uint64_t(INT32_MAX)) {
+      LOG(WARNING) << "Closing connection after request with " << header.n
+                   << " vertices and " << header.m << " edges.";
+      state.finished(false, {});
+      return;
+    }
+    const uint64_t bytes = BinaryFormat::byteSize(header);
+    if (bytes > options.maxRequestBytes) {
+      LOG(WARNING) << "Closing connection after request of " << bytes
+                   << " bytes, which is more than " << options.maxRequestBytes
+                   << ".";
+      state.finished(false, {});
+      return;
+    }
+
+    // Keep the graph in 64-bit words such that its offsets are aligned.
+    request.resize((bytes + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+    char *data = reinterpret_cast<char *>(request.data());
+    memcpy(data, &header, sizeof(header));
+    if (readAll(connection.fd, data + sizeof(header), bytes - sizeof(header),
+                timedOut) != bytes - sizeof(header)) {
+      LOG(WARNING) << (timedOut ? "Closing connection after request timed out."
+                                : "Connection closed during request.");
+      state.finished(false, {});
+      return;
+    }
+
+    BinaryFormat::View view;
+    const std::string error = BinaryFormat::tryParse(data, data + bytes, view);
+    if (!error.empty()) {
+      LOG(WARNING) << "Closing connection after invalid graph: " << error;
+      state.finished(false, {});
+      return;
+    }
+
+    randomGen.seed(chooseSeed(options.seed));
+    solver.decompose(std::make_unique<Undirected::Graph>(
+        int(view.n), view.offsets, view.neighbors));
+
+    Output::Writer out(connection.fd);
+    Output::writeBinary(out, solver.getEdgesCut(), solver.getPartitionOf(),
+                        solver.getConductance());
+    out.flush();
+    state.finished(out.good(), Clock::now() - arrived);
+    if (!out.good())
+      return;
+    arrived = Clock::time_point();
+  }
+}
+
+} // namespace Server
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#include "lib/expander_decomp.hpp"
+
+/**
+   Decompositions of graphs sent over socket connections, as served by
+   'edc-server'.
+ */
+namespace Server {
+
+using Clock = std::chrono::steady_clock;
+
+/**
+   Connection accepted but not yet served by a worker.
+ */
+struct Connection {
+  int fd;
+  Clock::time_point accepted;
+};
+
+/**
+   Connections waiting for a worker, and statistics reported by the stats
+   socket.
+ */
+struct State {
+  std::mutex lock;
+  std::condition_variable changed;
+  std::deque<Connection> queue;
+
+  int active = 0;
+  long long completed = 0, failed = 0, rejected = 0;
+  Clock::duration totalLatency{0}, maxLatency{0};
+
+  /**
+     Record a request which took 'latency' from arriving to being answered.
+   */
+  void finished(bool ok, Clock::duration latency);
+
+  /**
+     Queue 'connection' and wake a worker, unless 'maxQueued' connections are
+     already waiting. Return false if the connection was rejected, in which case
+     the caller should close it.
+   */
+  bool enqueue(const Connection &connection, size_t maxQueued);
+};
+
+struct Options {
+  /**
+     Seed used for every request, or '0' for a random seed per request.
+   */
+  unsigned int seed;
+
+  /**
+     Requests larger than this are rejected from their header, before memory
+     for the graph is allocated.
+   */
+  uint64_t maxRequestBytes;
+
+  /**
+     Requests are failed once a read or write on their connection makes no
+     progress for this long, such that clients which stop sending cannot hold
+     on to a worker. Zero disables the timeout.
+   */
+  Clock::duration timeout{0};
+};
+
+/**
+   Answer graphs sent over the connection 'fd' until the client closes it.
+   Each request is a graph in the binary format and each response is its
+   decomposition in the binary partition format. The worker's solver and
+   request buffer are reused between requests. Invalid requests close the
+   connection, as do requests which time out, see 'Options::timeout'.
+ */
+void serve(State &state, const Connection &connection, const Options &options,
+           ExpanderDecomposition::Solver &solver, std::mt19937 &randomGen,
+           std::vector<uint64_t> &request);
+
+} // namespace Server
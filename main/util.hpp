@@ -1,15 +1,28 @@
 #pragma once
 
+#include <algorithm>
+#include <glog/logging.h>
 #include <iostream>
 #include <memory>
-#include <set>
+#include <random>
 #include <string>
 
+#include "main/binary_format.hpp"
+#include "main/input.hpp"
 #include "lib/datastructures/undirected_graph.hpp"
 
-std::unique_ptr<std::mt19937> configureRandomness(unsigned int seed) {
+/**
+   Return 'seed', or a random seed if 'seed' is zero. Unlike
+   'configureRandomness' this does not seed the global C generator, so it can
+   be used from several threads at once.
+ */
+inline unsigned int chooseSeed(unsigned int seed) {
   std::random_device rd;
-  const unsigned int s = seed == 0 ? int(rd()) : seed;
+  return seed == 0 ? int(rd()) : seed;
+}
+
+inline std::unique_ptr<std::mt19937> configureRandomness(unsigned int seed) {
+  const unsigned int s = chooseSeed(seed);
 
   std::srand(s);
   std::mt19937 randomGen(s);
@@ -18,41 +31,62 @@ std::unique_ptr<std::mt19937> configureRandomness(unsigned int seed) {
 }
 
 /**
-   Read an undirected graph from standard input. If 'chaco_format' is true, read
-   graph as specified in 'https://chriswalshaw.co.uk/jostle/jostle-exe.pdf'.
-   Otherwise assume edges are given as 'm' vertex pairs. Duplicate edges are
-   ignored.
+   Read an undirected graph from the file at 'path', or from standard input if
+   'path' is empty, and call 'f(n, offsets, neighbors)' with its adjacency
+   array. The arrays are only valid during the call. The text format is one of:
+   - "edgelist": A line with 'n' and 'm' followed by 'm' 0-indexed vertex
+     pairs.
+   - "chaco" or "metis": As specified in
+     'https://chriswalshaw.co.uk/jostle/jostle-exe.pdf', with the METIS
+     extensions for vertex and edge weights.
+   - "mtx": A square sparse matrix in the Matrix Market coordinate format.
+   - "snap": An edge list from the SNAP archive with arbitrary vertex ids.
+   Duplicate edges and self-loops are ignored and adjacency lists are sorted.
+
+   Input compressed with gzip or xz is detected from its magic bytes and
+   decompressed on a separate thread while earlier blocks are parsed.
+   Uncompressed files are memory mapped instead. Text is parsed in parallel.
+   Graphs in the binary format, see 'BinaryFormat', are detected automatically
+   regardless of 'format' and their arrays are used directly.
  */
-std::unique_ptr<Undirected::Graph> readGraph(bool chaco_format) {
-  int n, m;
-  std::cin >> n >> m;
-
-  std::vector<Undirected::Edge> es;
-  if (chaco_format) {
-    std::cin.ignore();
-    for (int u = 0; u < n; ++u) {
-      std::string line;
-      std::getline(std::cin, line);
-      std::stringstream ss(line);
-
-      int v;
-      while (ss >> v)
-        if (u < --v)
-          es.emplace_back(u, v);
-    }
-  } else {
-    std::set<std::pair<int, int>> seen;
-    for (int i = 0; i < m; ++i) {
-      int u, v;
-      std::cin >> u >> v;
-      if (u > v)
-        std::swap(u, v);
-      if (seen.find({u, v}) == seen.end()) {
-        seen.insert({u, v});
-        es.emplace_back(u, v);
-      }
-    }
+template <typename F>
+auto withAdjacency(const std::string &format, const std::string &path, F f) {
+  const auto source = Input::Source::open(path);
+  source->fill(sizeof(BinaryFormat::magic));
+  if (BinaryFormat::matches(source->begin(), source->end())) {
+    source->fillAll();
+    const auto view = BinaryFormat::parse(source->begin(), source->end());
+    return f(view.n, view.offsets, view.neighbors);
   }
 
-  return std::make_unique<Undirected::Graph>(n, es);
+  const int threads = Input::defaultThreads();
+  Input::Adjacency adjacency;
+  if (format == "edgelist")
+    adjacency = Input::readEdgeList(*source, threads);
+  else if (format == "chaco" || format == "metis")
+    adjacency = Input::readMetis(*source, threads);
+  else if (format == "mtx")
+    adjacency = Input::readMatrixMarket(*source, threads);
+  else if (format == "snap")
+    adjacency = Input::readSnap(*source, threads);
+  else
+    LOG(FATAL) << "Unknown graph format '" << format << "'.";
+
+  const uint64_t n = adjacency.offsets.size() - 1;
+  return f(n, adjacency.offsets.data(), adjacency.neighbors.data());
+}
+
+/**
+   Read an undirected graph with vertex indices of type 'V', see
+   'withAdjacency'.
+ */
+template <typename V = int>
+std::unique_ptr<Undirected::BasicGraph<V>>
+readGraph(const std::string &format, const std::string &path = "") {
+  return withAdjacency(format, path,
+                       [](uint64_t n, const uint64_t *offsets,
+                          const uint32_t *neighbors) {
+                         return std::make_unique<Undirected::BasicGraph<V>>(
+                             V(n), offsets, neighbors);
+                       });
 }
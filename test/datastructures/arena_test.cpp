@@ -0,0 +1,40 @@
+#include "gtest/gtest.h"
+
+#include "lib/datastructures/arena.hpp"
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+TEST(Arena, AlignsAllocations) {
+  Arena::Resource arena;
+  for (size_t alignment : {1, 2, 8, 64, 4096}) {
+    (void)arena.allocate(3, 1);
+    const void *p = arena.allocate(100, alignment);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % alignment, 0u);
+  }
+}
+
+/**
+   After a reset, repeating the same allocations should fit in the blocks
+   already held.
+ */
+TEST(Arena, ResetReusesBlocks) {
+  Arena::Resource arena;
+  auto work = [&arena]() {
+    std::pmr::vector<int> xs(&arena);
+    for (int i = 0; i < 100000; ++i)
+      xs.push_back(i);
+    std::pmr::vector<int> ys(xs.rbegin(), xs.rend(), &arena);
+    EXPECT_EQ(ys.front(), 99999);
+  };
+
+  work();
+  arena.reset();
+  const size_t capacity = arena.capacity();
+  for (int i = 0; i < 3; ++i) {
+    work();
+    arena.reset();
+    EXPECT_EQ(arena.capacity(), capacity);
+  }
+}
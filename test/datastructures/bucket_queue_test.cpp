@@ -0,0 +1,34 @@
+#include "gtest/gtest.h"
+
+#include "lib/datastructures/bucket_queue.hpp"
+
+TEST(BucketQueue, BucketsAreFirstInFirstOut) {
+  BucketQueue::Buckets<int> buckets;
+  buckets.reserve(10, 3);
+  for (int u : {4, 2, 7})
+    buckets.push(1, u);
+  buckets.push(2, 0);
+
+  for (int u : {4, 2, 7}) {
+    ASSERT_FALSE(buckets.empty(1));
+    EXPECT_EQ(buckets.front(1), u);
+    buckets.pop(1);
+  }
+  EXPECT_TRUE(buckets.empty(1));
+  EXPECT_EQ(buckets.front(2), 0);
+}
+
+TEST(BucketQueue, NextNonEmptySkipsEmptyWords) {
+  BucketQueue::Buckets<int> buckets;
+  buckets.reserve(2, 300);
+  EXPECT_EQ(buckets.nextNonEmpty(0), 300u);
+
+  buckets.push(63, 0);
+  buckets.push(200, 1);
+  EXPECT_EQ(buckets.nextNonEmpty(0), 63u);
+  EXPECT_EQ(buckets.nextNonEmpty(63), 63u);
+  EXPECT_EQ(buckets.nextNonEmpty(64), 200u);
+
+  buckets.pop(200);
+  EXPECT_EQ(buckets.nextNonEmpty(64), 300u);
+}
@@ -0,0 +1,22 @@
+#include "gtest/gtest.h"
+
+#include "lib/datastructures/huge_pages.hpp"
+
+#include <cstdint>
+
+/**
+   Large vectors should start on a huge page boundary, and behave as any
+   other vector.
+ */
+TEST(HugePages, AlignsLargeVectors) {
+  HugePages::Vector<int> xs(HugePages::pageSize / sizeof(int), 1);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(xs.data()) % HugePages::pageSize, 0u);
+
+  xs.push_back(2);
+  EXPECT_EQ(xs.back(), 2);
+  EXPECT_EQ(xs.front(), 1);
+
+  HugePages::Vector<int> ys(3, 1);
+  ys.push_back(2);
+  EXPECT_EQ(ys, HugePages::Vector<int>({1, 1, 1, 2}));
+}
@@ -0,0 +1,34 @@
+#include "gtest/gtest.h"
+
+#include "lib/datastructures/level_cut.hpp"
+
+#include <vector>
+
+TEST(LevelCut, CutsAtLowestConductance) {
+  LevelCut::Levels<int, long long> levels;
+  levels.clear(3);
+  // Level 2 has a single edge to level 1 while level 3 has many to level 2.
+  levels.add(0, 0, 10, 0);
+  levels.add(3, 1, 4, 4);
+  levels.add(2, 2, 6, 1);
+  levels.add(1, 3, 10, 5);
+  levels.add(2, 4, 2, 0);
+
+  const auto [left, right] = levels.cut(32);
+  EXPECT_EQ(left, std::vector<int>({1, 2, 4}));
+  EXPECT_EQ(right, std::vector<int>({0, 3}));
+}
+
+TEST(LevelCut, DefaultsToTopLevel) {
+  LevelCut::Levels<int, long long> levels;
+  for (int i = 0; i < 2; ++i) {
+    levels.clear(2);
+    levels.add(0, 0, 1, 0);
+    levels.add(1, 1, 1, 1);
+    levels.add(2, 2, 1, 1);
+
+    const auto [left, right] = levels.cut(3);
+    EXPECT_EQ(left, std::vector<int>({2}));
+    EXPECT_EQ(right, std::vector<int>({0, 1}));
+  }
+}
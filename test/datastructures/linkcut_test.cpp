@@ -294,7 +294,7 @@ struct NaiveTree {
       u = parent[u];
     }
   }
-  std::pair<int, int> findPathMin(int u) {
+  std::pair<int, LinkCut::Vertex> findPathMin(int u) {
     if (parent[u] == -1)
       return {weight[u], u};
 
@@ -0,0 +1,160 @@
+#include "gtest/gtest.h"
+
+#include "lib/datastructures/subdivision_flow.hpp"
+
+#include <random>
+#include <set>
+#include <vector>
+
+/**
+   Split vertices should be adjacent to the endpoints of their edge, in the
+   order edges are listed.
+ */
+TEST(SubdivisionFlow, Construct) {
+  const std::vector<Undirected::Edge> es = {{0, 1}, {1, 2}, {0, 2}, {2, 3}};
+  const Undirected::Graph g(4, es);
+  const SubdivisionFlow::Graph f(g);
+
+  EXPECT_EQ(f.size(), 8);
+  EXPECT_EQ(f.originalSize(), 4);
+  EXPECT_EQ(f.edgeCount(), 8);
+  EXPECT_EQ(f.neighbors(0), std::vector<int>({4, 5}));
+  EXPECT_EQ(f.neighbors(2), std::vector<int>({5, 6, 7}));
+  EXPECT_EQ(f.neighbors(4), std::vector<int>({0, 1}));
+  EXPECT_EQ(f.neighbors(7), std::vector<int>({2, 3}));
+}
+
+/**
+   The subdivision graph with flow type 'F' should order vertices and adjacency
+   lists and route flow exactly as a materialised subdivision graph under a
+   random sequence of operations.
+ */
+template <typename F> void expectMatchesMaterialisedGraph() {
+  std::mt19937 randomGen(3);
+  const int n = 30;
+  std::set<std::pair<int, int>> pairs;
+  for (int i = 0; i < 90; ++i) {
+    const int u = randomGen() % n, v = randomGen() % n;
+    if (u != v)
+      pairs.insert({std::min(u, v), std::max(u, v)});
+  }
+  std::vector<Undirected::Edge> es;
+  for (auto [u, v] : pairs)
+    es.emplace_back(u, v);
+  const Undirected::Graph g(n, es);
+
+  const UnitFlow::Flow capacity = 2;
+  std::vector<UnitFlow::Edge> subdivisionEdges;
+  for (int u = 0; u < n; ++u)
+    for (auto e = g.cbeginEdge(u); e != g.cendEdge(u); ++e)
+      if (e->from < e->to) {
+        const int split = n + int(subdivisionEdges.size()) / 2;
+        subdivisionEdges.emplace_back(e->from, split, capacity);
+        subdivisionEdges.emplace_back(e->to, split, capacity);
+      }
+  UnitFlow::Graph expected(n + int(subdivisionEdges.size()) / 2,
+                           subdivisionEdges);
+  SubdivisionFlow::BasicGraph<int, F> f(g);
+  f.setCapacity(capacity);
+
+  auto expectSame = [&]() {
+    ASSERT_EQ(std::vector<int>(f.cbegin(), f.cendRemoved()),
+              std::vector<int>(expected.cbegin(), expected.cendRemoved()));
+    ASSERT_EQ(f.size(), expected.size());
+    ASSERT_EQ(f.volume(), expected.volume());
+    ASSERT_EQ(f.removedGlobalVolume(), expected.removedGlobalVolume());
+    for (auto u : f)
+      ASSERT_EQ(f.neighbors(u), expected.neighbors(u));
+  };
+
+  int depth = 0;
+  for (int i = 0; i < 300; ++i) {
+    switch (randomGen() % 5) {
+    case 0: {
+      if (f.size() > 0) {
+        const int u = *(f.cbegin() + randomGen() % f.size());
+        f.remove(u), expected.remove(u);
+      }
+      break;
+    }
+    case 1: {
+      f.restoreRemoves(), expected.restoreRemoves();
+      std::vector<int> xs;
+      for (auto u : f)
+        if (u < n && randomGen() % 3 != 0)
+          xs.push_back(u);
+      const auto ys = f.subdivisionVertices(xs.begin(), xs.end());
+      ASSERT_EQ(ys, expected.subdivisionVertices(xs.begin(), xs.end()));
+      f.subgraph(ys.begin(), ys.end()), expected.subgraph(ys.begin(), ys.end());
+      depth++;
+      break;
+    }
+    case 2: {
+      if (depth > 0) {
+        f.restoreRemoves(), expected.restoreRemoves();
+        f.restoreSubgraph(), expected.restoreSubgraph();
+        depth--;
+      }
+      break;
+    }
+    case 3: {
+      f.restoreRemoves(), expected.restoreRemoves();
+      break;
+    }
+    case 4: {
+      f.reset(), expected.reset();
+      std::vector<int> sources;
+      for (auto u : f) {
+        if (randomGen() % 3 == 0)
+          sources.push_back(u), f.addSource(u, 1), expected.addSource(u, 1);
+        else if (randomGen() % 2 == 0)
+          f.addSink(u, 1), expected.addSink(u, 1);
+      }
+      const int h = 1 + randomGen() % 10;
+      ASSERT_EQ(f.compute(h), expected.compute(h));
+      ASSERT_EQ(f.levelCut(h), expected.levelCut(h));
+
+      UnitFlow::Flow congestion = 0;
+      for (auto u : expected)
+        for (auto e = expected.cbeginEdge(u); e != expected.cendEdge(u); ++e)
+          congestion = std::max(congestion, e->congestion);
+      ASSERT_EQ(f.congestion(), congestion);
+
+      ASSERT_EQ(f.matching(sources.begin(), sources.end()),
+                expected.matching(sources,
+                                  UnitFlow::Graph::MatchingMethod::Dfs));
+      break;
+    }
+    }
+    expectSame();
+  }
+}
+
+TEST(SubdivisionFlow, MatchesMaterialisedGraph) {
+  expectMatchesMaterialisedGraph<int32_t>();
+}
+
+TEST(SubdivisionFlow, MatchesMaterialisedGraphWideFlow) {
+  expectMatchesMaterialisedGraph<int64_t>();
+}
+
+/**
+   'reset' should clear the flow state of every vertex touched since the last
+   reset, including vertices which have been removed from the subgraph.
+ */
+TEST(SubdivisionFlow, ResetClearsRemovedVertices) {
+  const Undirected::Graph g(3, {{0, 1}, {1, 2}});
+  SubdivisionFlow::Graph f(g);
+  f.setCapacity(1);
+
+  f.addSource(0, 5);
+  f.addSink(2, 1);
+  EXPECT_EQ(f.compute(10), std::vector<int>({0}));
+
+  f.remove(0);
+  f.reset();
+  f.restoreRemoves();
+  for (auto u : f)
+    EXPECT_EQ(f.excess(u), 0);
+  EXPECT_TRUE(f.compute(10).empty());
+}
@@ -59,6 +59,34 @@ TEST(SubsetGraph, ConstructComplete) {
   EXPECT_EQ(g.edgeCount(), n * (n - 1) / 2);
 }
 
+/**
+   Construct a small graph from an adjacency array and verify that neighbors
+   and reverse edges are correct.
+ */
+TEST(SubsetGraph, ConstructFromAdjacencyArray) {
+  const int n = 5;
+  const std::vector<long> offsets = {0, 3, 5, 7, 8, 10};
+  const std::vector<unsigned> neighbors = {1, 2, 4, 0, 2, 0, 1, 4, 0, 3};
+  Graph g(n, offsets.data(), neighbors.data());
+
+  ASSERT_EQ(g.size(), n);
+  ASSERT_EQ(g.edgeCount(), 5);
+  EXPECT_EQ(g.neighbors(0), std::vector<int>({1, 2, 4}));
+  EXPECT_EQ(g.neighbors(1), std::vector<int>({0, 2}));
+  EXPECT_EQ(g.neighbors(2), std::vector<int>({0, 1}));
+  EXPECT_EQ(g.neighbors(3), std::vector<int>({4}));
+  EXPECT_EQ(g.neighbors(4), std::vector<int>({0, 3}));
+
+  for (auto u : g) {
+    for (auto e = g.beginEdge(u); e != g.endEdge(u); ++e) {
+      ASSERT_EQ(e->from, u);
+      const auto &re = g.reverse(*e);
+      ASSERT_EQ(re.from, e->to);
+      ASSERT_EQ(re.to, u);
+    }
+  }
+}
+
 /**
    Test that 'reverse' returns the correct edge.
  */
@@ -247,6 +275,26 @@ TEST(SubsetGraph, RestoreSubgraphSimple) {
   EXPECT_EQ(seen, subset1);
 }
 
+/**
+   Restoring a subgraph should restore the edges of vertices which were removed
+   in it.
+ */
+TEST(SubsetGraph, RestoreSubgraphWithRemoves) {
+  Graph g(5, {{0, 1}, {0, 2}, {1, 2}, {2, 3}, {3, 4}});
+
+  std::vector<int> xs = {0, 1, 2};
+  g.subgraph(xs.begin(), xs.end());
+  g.remove(2);
+  EXPECT_EQ(g.degree(0), 1);
+  g.restoreSubgraph();
+
+  EXPECT_EQ(g.size(), 5);
+  EXPECT_EQ(g.edgeCount(), 5);
+  EXPECT_EQ(g.degree(0), 2);
+  EXPECT_EQ(g.degree(2), 3);
+  EXPECT_EQ(g.degree(4), 1);
+}
+
 /**
    Remove some vertices, restore removes, verify entire graph is restored.
  */
@@ -313,3 +361,174 @@ TEST(SubsetGraph, SubdivisionVerticesOnSubgraph) {
 
   EXPECT_EQ(rs, std::vector<int>({0, 3, 4}));
 }
+
+TEST(SubsetGraph, AssignReplacesGraph) {
+  Graph g(5, {{0, 1}, {0, 2}, {0, 3}, {0, 4}});
+
+  std::vector<int> xs = {0, 3, 4};
+  g.subgraph(xs.begin(), xs.end());
+  g.remove(3);
+
+  g.assign(3, {{0, 1}, {1, 2}});
+
+  EXPECT_EQ(g.size(), 3);
+  EXPECT_EQ(g.removedSize(), 0);
+  EXPECT_EQ(g.edgeCount(), 2);
+  EXPECT_EQ(g.neighbors(0), std::vector<int>({1}));
+  EXPECT_EQ(g.neighbors(1), std::vector<int>({0, 2}));
+  EXPECT_EQ(g.neighbors(2), std::vector<int>({1}));
+  for (auto u : g)
+    for (auto e = g.cbeginEdge(u); e != g.cendEdge(u); ++e)
+      EXPECT_EQ(g.reverse(*e).to, u);
+}
+
+/**
+   Graphs with flat and nested adjacency storage should have identical
+   adjacency lists after the same sequence of random operations.
+ */
+TEST(SubsetGraph, FlatAndNestedAdjacencyAgree) {
+  using Edge = Undirected::Edge;
+  using Nested =
+      SubsetGraph::Graph<int, Edge, SubsetGraph::NestedAdjacency<int, Edge>>;
+  using Flat =
+      SubsetGraph::Graph<int, Edge, SubsetGraph::FlatAdjacency<int, Edge>>;
+
+  std::mt19937 randomGen(0);
+  const int n = 50;
+  std::set<std::pair<int, int>> pairs;
+  for (int i = 0; i < 200; ++i) {
+    const int u = randomGen() % n, v = randomGen() % n;
+    if (u != v)
+      pairs.insert({std::min(u, v), std::max(u, v)});
+  }
+  std::vector<Edge> es;
+  for (auto [u, v] : pairs)
+    es.emplace_back(u, v);
+  Nested nested(n, es);
+  Flat flat(n, es);
+
+  auto expectEqual = [&] {
+    ASSERT_EQ(std::vector<int>(nested.cbegin(), nested.cend()),
+              std::vector<int>(flat.cbegin(), flat.cend()));
+    for (int u = 0; u < n; ++u) {
+      ASSERT_EQ(nested.neighbors(u), flat.neighbors(u));
+      for (auto e = flat.cbeginEdge(u); e != flat.cendEdge(u); ++e)
+        ASSERT_EQ(flat.reverse(*e).to, u);
+    }
+  };
+
+  // As in the expander decomposition, subgraphs are only taken and restored
+  // when no vertices are removed.
+  int depth = 0;
+  for (int i = 0; i < 1000; ++i) {
+    switch (randomGen() % 4) {
+    case 0: {
+      if (nested.size() > 0) {
+        const int u = *(nested.cbegin() + randomGen() % nested.size());
+        nested.remove(u), flat.remove(u);
+      }
+      break;
+    }
+    case 1: {
+      nested.restoreRemoves(), flat.restoreRemoves();
+      std::vector<int> xs;
+      for (auto it = nested.cbegin(); it != nested.cend(); ++it)
+        if (randomGen() % 2 == 0)
+          xs.push_back(*it);
+      nested.subgraph(xs.begin(), xs.end());
+      flat.subgraph(xs.begin(), xs.end());
+      depth++;
+      break;
+    }
+    case 2: {
+      if (depth > 0) {
+        nested.restoreRemoves(), flat.restoreRemoves();
+        nested.restoreSubgraph(), flat.restoreSubgraph();
+        depth--;
+      }
+      break;
+    }
+    case 3: {
+      nested.restoreRemoves(), flat.restoreRemoves();
+      break;
+    }
+    }
+    expectEqual();
+  }
+}
+
+/**
+   Volumes maintained by the graph should agree with summing degrees after
+   every operation in a random sequence.
+ */
+TEST(SubsetGraph, VolumesMatchDegrees) {
+  std::mt19937 randomGen(1);
+  const int n = 40;
+  std::set<std::pair<int, int>> pairs;
+  for (int i = 0; i < 150; ++i) {
+    const int u = randomGen() % n, v = randomGen() % n;
+    if (u != v)
+      pairs.insert({std::min(u, v), std::max(u, v)});
+  }
+  std::vector<Undirected::Edge> es;
+  for (auto [u, v] : pairs)
+    es.emplace_back(u, v);
+  Graph g(n, es);
+
+  int depth = 0;
+  for (int i = 0; i < 1000; ++i) {
+    switch (randomGen() % 4) {
+    case 0: {
+      if (g.size() > 0)
+        g.remove(*(g.cbegin() + randomGen() % g.size()));
+      break;
+    }
+    case 1: {
+      g.restoreRemoves();
+      std::vector<int> xs;
+      for (auto it = g.cbegin(); it != g.cend(); ++it)
+        if (randomGen() % 2 == 0)
+          xs.push_back(*it);
+      g.subgraph(xs.begin(), xs.end());
+      depth++;
+      break;
+    }
+    case 2: {
+      if (depth > 0)
+        g.restoreSubgraph(), depth--;
+      break;
+    }
+    case 3: {
+      g.restoreRemoves();
+      break;
+    }
+    }
+    ASSERT_EQ(g.volume(), g.volume(g.cbegin(), g.cend()));
+    ASSERT_EQ(g.edgeCount(), g.volume(g.cbegin(), g.cend()) / 2);
+    ASSERT_EQ(g.globalVolume(), g.globalVolume(g.cbegin(), g.cend()));
+    ASSERT_EQ(g.removedGlobalVolume(),
+              g.globalVolume(g.cbeginRemoved(), g.cendRemoved()));
+  }
+}
+
+/**
+   Memory usage should account for every edge slot and every vertex, and its
+   total should be the sum of its components.
+ */
+TEST(SubsetGraph, MemoryUsageCountsStorage) {
+  const std::vector<Undirected::Edge> es = {{0, 1}, {1, 2}, {2, 0}, {2, 3}};
+  Graph g(4, es);
+
+  const auto usage = g.memoryUsage();
+  size_t edges = 0, vertices = 0, total = 0;
+  for (const auto &[name, bytes] : usage.getComponents()) {
+    if (name == "edges")
+      edges = bytes;
+    else if (name == "vertices")
+      vertices = bytes;
+    total += bytes;
+  }
+  EXPECT_GE(edges, 2 * es.size() * sizeof(Undirected::Edge));
+  EXPECT_GE(vertices, 4 * sizeof(int));
+  EXPECT_EQ(usage.total(), total);
+}
@@ -386,7 +386,9 @@ TEST(UnitFlow, Reset) {
 }
 
 /**
-   'reset' should set all flow, height, absorbtion and sinks to 0.
+   'reset' of a subset should set flow, height, absorbtion and sinks of the
+   subset to 0, leaving other vertices as they were apart from flow on edges
+   into the subset.
  */
 TEST(UnitFlow, ResetSubset) {
   const std::vector<UnitFlow::Edge> es = {{0, 1, 10}, {0, 2, 10}, {1, 2, 10},
@@ -397,6 +399,7 @@ TEST(UnitFlow, ResetSubset) {
 
   uf.compute(INT_MAX);
 
+  const auto absorbed = uf.getAbsorbed(), sink = uf.getSink();
   std::vector<int> subset = {1, 2, 3};
   uf.reset(subset.begin(), subset.end());
 
@@ -405,7 +408,202 @@ TEST(UnitFlow, ResetSubset) {
     EXPECT_EQ(uf.getSink()[u], 0);
     EXPECT_EQ(uf.getHeight()[u], 0);
     EXPECT_EQ(uf.getNextEdgeIdx()[u], 0);
-    for (auto e = uf.beginEdge(u); e != uf.endEdge(u); ++e)
+    for (auto e = uf.beginEdge(u); e != uf.endEdge(u); ++e) {
       EXPECT_EQ(e->flow, 0);
+      EXPECT_EQ(uf.reverse(*e).flow, 0);
+    }
+  }
+  for (auto u : {0, 4}) {
+    EXPECT_EQ(uf.getAbsorbed()[u], absorbed[u]);
+    EXPECT_EQ(uf.getSink()[u], sink[u]);
+  }
+  for (int u = 0; u < 5; ++u) {
+    UnitFlow::Flow out = 0;
+    for (auto e = uf.beginEdge(u); e != uf.endEdge(u); ++e)
+      out += std::max<UnitFlow::Flow>(e->flow, 0);
+    EXPECT_EQ(uf.flowOut(u), out) << "u = " << u;
+  }
+}
+
+/**
+   Resuming a flow after removing vertices and adding sources to their
+   neighbors, as in trimming, should give the same flow as computing it again.
+ */
+TEST(UnitFlow, ResumeMatchesCompute) {
+  for (int iteration = 0; iteration < 100; ++iteration) {
+    std::srand(iteration);
+    constexpr int n = 60, m = 150, h = 6;
+
+    std::vector<UnitFlow::Edge> es;
+    for (int i = 0; i < m; ++i) {
+      int u = rand() % n, v = rand() % n;
+      if (u != v)
+        es.emplace_back(u, v, 2);
+    }
+
+    UnitFlow::Graph computed(n, es), resumed(n, es);
+    for (int u = 0; u < n; ++u) {
+      const int source = u < 10 ? 3 * computed.degree(u) : 0,
+                sink = computed.degree(u);
+      computed.addSource(u, source), resumed.addSource(u, source);
+      computed.addSink(u, sink), resumed.addSink(u, sink);
+    }
+
+    auto hasExcess = computed.compute(h);
+    ASSERT_EQ(resumed.compute(h), hasExcess);
+
+    while (!hasExcess.empty()) {
+      const auto [cut, _] = computed.levelCut(h);
+      ASSERT_EQ(resumed.levelCut(h).first, cut);
+      if (cut.empty())
+        break;
+
+      std::vector<int> neighbors;
+      for (auto u : cut)
+        for (auto e = computed.beginEdge(u); e != computed.endEdge(u); ++e)
+          neighbors.push_back(e->to);
+
+      for (auto u : cut)
+        computed.remove(u), resumed.remove(u);
+
+      std::vector<int> touched = hasExcess;
+      for (auto v : neighbors)
+        if (computed.alive(v)) {
+          computed.addSource(v, 2), resumed.addSource(v, 2);
+          touched.push_back(v);
+        }
+
+      hasExcess = computed.compute(h);
+      ASSERT_EQ(resumed.resume(h, touched), hasExcess);
+      for (auto u : computed)
+        ASSERT_EQ(resumed.getHeight()[u], computed.getHeight()[u]);
+    }
+  }
+}
+
+/**
+   Adding source to vertices left at a nonzero height by a bounded flow and
+   resuming from them should give the same flow as computing it again, which
+   also starts from the heights left.
+ */
+TEST(UnitFlow, ResumeMatchesComputeAtNonzeroHeights) {
+  for (int iteration = 0; iteration < 100; ++iteration) {
+    std::srand(iteration);
+    constexpr int n = 40, m = 100, h = 5;
+
+    std::vector<UnitFlow::Edge> es;
+    for (int i = 0; i < m; ++i) {
+      int u = rand() % n, v = rand() % n;
+      if (u != v)
+        es.emplace_back(u, v, 1 + rand() % 3);
+    }
+
+    UnitFlow::Graph computed(n, es), resumed(n, es);
+    for (int u = 0; u < n; ++u) {
+      const int source = u < 8 ? 4 * computed.degree(u) : 0,
+                sink = rand() % 3;
+      computed.addSource(u, source), resumed.addSource(u, source);
+      computed.addSink(u, sink), resumed.addSink(u, sink);
+    }
+
+    auto hasExcess = computed.compute(h);
+    ASSERT_EQ(resumed.compute(h), hasExcess);
+
+    for (int round = 0; round < 3; ++round) {
+      std::vector<int> touched = hasExcess;
+      for (int u = 0; u < n; ++u)
+        if (computed.getHeight()[u] > 0 && rand() % 2 == 0) {
+          computed.addSource(u, 1 + rand() % 3);
+          resumed.addSource(u, computed.getAbsorbed()[u] -
+                                   resumed.getAbsorbed()[u]);
+          touched.push_back(u);
+        }
+
+      hasExcess = computed.compute(h);
+      ASSERT_EQ(resumed.resume(h, touched), hasExcess);
+      for (int u = 0; u < n; ++u) {
+        ASSERT_EQ(resumed.getHeight()[u], computed.getHeight()[u]);
+        ASSERT_EQ(resumed.excess(u), computed.excess(u));
+      }
+    }
+  }
+}
+
+/**
+   Without a height bound push-relabel finds a maximum preflow, so the excess
+   left should not depend on the heuristics used.
+ */
+TEST(UnitFlow, HeuristicsLeaveSameExcess) {
+  for (int iteration = 0; iteration < 100; ++iteration) {
+    std::srand(iteration);
+    constexpr int n = 40, m = 80;
+
+    std::vector<UnitFlow::Edge> es;
+    for (int i = 0; i < m; ++i) {
+      int u = rand() % n, v = rand() % n;
+      if (u != v)
+        es.emplace_back(u, v, 1 + rand() % 4);
+    }
+    std::vector<int> sources(n), sinks(n);
+    for (int u = 0; u < n; ++u)
+      sources[u] = rand() % 3 == 0 ? rand() % 10 : 0, sinks[u] = rand() % 3;
+
+    std::vector<UnitFlow::Flow> excess;
+    for (int heuristic = 0; heuristic < 4; ++heuristic) {
+      UnitFlow::Graph uf(n, es);
+      for (int u = 0; u < n; ++u)
+        uf.addSource(u, sources[u]), uf.addSink(u, sinks[u]);
+
+      const auto hasExcess =
+          uf.compute(INT_MAX, {.globalRelabel = bool(heuristic & 1),
+                               .gap = bool(heuristic & 2)});
+      UnitFlow::Flow total = 0;
+      for (auto u : hasExcess)
+        total += uf.excess(u);
+      excess.push_back(total);
+    }
+    EXPECT_EQ(excess, std::vector<UnitFlow::Flow>(4, excess[0]));
+  }
+}
+
+/**
+   'flowOut' should equal the positive flow across the edges of a vertex after
+   computing a flow and after a matching mutates it.
+ */
+TEST(UnitFlow, FlowOutMatchesEdges) {
+  for (int iteration = 0; iteration < 50; ++iteration) {
+    std::srand(iteration);
+    constexpr int n = 30, m = 90;
+
+    std::vector<UnitFlow::Edge> es;
+    for (int i = 0; i < m; ++i) {
+      int u = rand() % n, v = rand() % n;
+      if (u != v)
+        es.emplace_back(u, v, 1 + rand() % 5);
+    }
+
+    UnitFlow::Graph uf(n, es);
+    std::vector<int> sources;
+    for (int u = 0; u < n; ++u) {
+      if (rand() % 3 == 0)
+        uf.addSource(u, 4), sources.push_back(u);
+      uf.addSink(u, rand() % 3);
+    }
+
+    auto check = [&uf]() {
+      for (int u = 0; u < n; ++u) {
+        UnitFlow::Flow f = 0;
+        for (auto e = uf.cbeginEdge(u); e != uf.cendEdge(u); ++e)
+          f += std::max((UnitFlow::Flow)0, e->flow);
+        ASSERT_EQ(uf.flowOut(u), f);
+      }
+    };
+
+    uf.compute(INT_MAX);
+    check();
+    uf.matching(sources, UnitFlow::Graph::MatchingMethod::Dfs);
+    check();
+    uf.reset();
+    check();
   }
 }
@@ -81,18 +81,10 @@ TEST(ConstructSubdivisionFlowGraph, SingleEdge) {
   EXPECT_EQ(f->degree(1), 1);
   EXPECT_EQ(f->degree(2), 2); // Split vertex
 
-  const auto &e02 = f->getEdge(0, 0);
-  const auto &e12 = f->getEdge(1, 0);
-
-  EXPECT_EQ(e02.from, 0);
-  EXPECT_EQ(e02.to, 2);
-  EXPECT_EQ(e02.flow, 0);
-  EXPECT_EQ(e02.capacity, 0);
-
-  EXPECT_EQ(e12.from, 1);
-  EXPECT_EQ(e12.to, 2);
-  EXPECT_EQ(e12.flow, 0);
-  EXPECT_EQ(e12.capacity, 0);
+  EXPECT_EQ(f->neighbors(0), std::vector<int>({2}));
+  EXPECT_EQ(f->neighbors(1), std::vector<int>({2}));
+  EXPECT_EQ(f->neighbors(2), std::vector<int>({0, 1}));
+  EXPECT_EQ(f->congestion(), 0);
 }
 
 TEST(ConstructSubdivisionFlowGraph, BasicGraph) {
@@ -104,3 +96,103 @@ TEST(ConstructSubdivisionFlowGraph, BasicGraph) {
   EXPECT_EQ(f->size(), n + g->edgeCount());
   EXPECT_EQ(f->edgeCount(), 2 * g->edgeCount());
 }
+
+/**
+   Parameters of the balanced cut strategy used by 'edc' by default.
+ */
+const CutMatching::Parameters params = {.tConst = 22,
+                                        .tFactor = 5.0,
+                                        .minIterations = 0,
+                                        .minBalance = 0.45,
+                                        .samplePotential = false,
+                                        .balancedCutStrategy = true};
+
+/**
+   Decomposing a graph with a solver which has already decomposed another graph
+   should give the same result as a new solver.
+ */
+TEST(Solver, DecomposeReusesSolver) {
+  // Two triangles connected by a single edge, and a path.
+  const std::vector<Undirected::Edge> es1 = {{0, 1}, {1, 2}, {2, 0}, {2, 3},
+                                             {3, 4}, {4, 5}, {5, 3}};
+  const std::vector<Undirected::Edge> es2 = {{0, 1}, {1, 2}, {2, 3}};
+
+  std::mt19937 randomGen(0);
+  ExpanderDecomposition::Solver reused(0.1, &randomGen, params);
+  reused.decompose(std::make_unique<Undirected::Graph>(6, es1));
+
+  randomGen.seed(1);
+  reused.decompose(std::make_unique<Undirected::Graph>(4, es2));
+  const auto partitions = reused.getPartition();
+  const auto conductances = reused.getConductance();
+
+  randomGen.seed(1);
+  ExpanderDecomposition::Solver fresh(
+      std::make_unique<Undirected::Graph>(4, es2), 0.1, &randomGen, params);
+
+  EXPECT_EQ(reused.getPartitionOf().size(), 4u);
+  EXPECT_EQ(partitions, fresh.getPartition());
+  EXPECT_EQ(conductances, fresh.getConductance());
+  EXPECT_EQ(reused.getEdgesCut(), fresh.getEdgesCut());
+}
+
+/**
+   A solver with 64-bit vertex indices should give the same decomposition as one
+   with 32-bit indices.
+ */
+TEST(Solver, WideIndicesGiveSameDecomposition) {
+  // Two triangles connected by a single edge.
+  const std::vector<std::pair<int, int>> edges = {
+      {0, 1}, {1, 2}, {2, 0}, {2, 3}, {3, 4}, {4, 5}, {5, 3}};
+  std::vector<Undirected::BasicEdge<int32_t>> narrowEdges;
+  std::vector<Undirected::BasicEdge<int64_t>> wideEdges;
+  for (auto [u, v] : edges)
+    narrowEdges.emplace_back(u, v), wideEdges.emplace_back(u, v);
+
+  std::mt19937 randomGen(0);
+  ExpanderDecomposition::BasicSolver<int32_t> narrow(
+      std::make_unique<Undirected::BasicGraph<int32_t>>(6, narrowEdges), 0.1,
+      &randomGen, params);
+
+  randomGen.seed(0);
+  ExpanderDecomposition::BasicSolver<int64_t> wide(
+      std::make_unique<Undirected::BasicGraph<int64_t>>(6, wideEdges), 0.1,
+      &randomGen, params);
+
+  const auto narrowPartitionOf = narrow.getPartitionOf();
+  const auto widePartitionOf = wide.getPartitionOf();
+  EXPECT_EQ(std::vector<int64_t>(narrowPartitionOf.begin(),
+                                 narrowPartitionOf.end()),
+            widePartitionOf);
+  EXPECT_EQ(narrow.getConductance(), wide.getConductance());
+  EXPECT_EQ(narrow.getEdgesCut(), wide.getEdgesCut());
+}
+
+/**
+   Extracting every subproblem into compact graphs should still find the
+   cliques of a path of cliques, with vertices labelled as in the input graph.
+ */
+TEST(Solver, ExtractedSubproblemsFindCliques) {
+  // Three cliques of six vertices connected by single edges, where clique 'i'
+  // consists of the vertices 'u' with 'u % 3 == i'.
+  const int n = 18;
+  std::vector<Undirected::Edge> es = {{0, 1}, {1, 2}};
+  for (int u = 0; u < n; ++u)
+    for (int v = u + 3; v < n; v += 3)
+      es.emplace_back(u, v);
+
+  std::mt19937 randomGen(0);
+  ExpanderDecomposition::Solver solver(
+      std::make_unique<Undirected::Graph>(n, es), 0.01, &randomGen, params,
+      1.0);
+
+  auto partitions = solver.getPartition();
+  for (auto &p : partitions)
+    std::sort(p.begin(), p.end());
+  std::sort(partitions.begin(), partitions.end());
+  EXPECT_EQ(partitions,
+            std::vector<std::vector<int>>({{0, 3, 6, 9, 12, 15},
+                                           {1, 4, 7, 10, 13, 16},
+                                           {2, 5, 8, 11, 14, 17}}));
+  EXPECT_EQ(solver.getEdgesCut(), 2);
+}
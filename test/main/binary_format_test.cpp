@@ -0,0 +1,203 @@
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "main/binary_format.hpp"
+
+/**
+   Contents of a file in the binary format, kept 8-byte aligned as required by
+   'BinaryFormat::parse'.
+ */
+struct Bytes {
+  std::vector<uint64_t> words;
+  size_t size;
+
+  explicit Bytes(const std::string &bytes)
+      : words((bytes.size() + 7) / 8), size(bytes.size()) {
+    std::memcpy(words.data(), bytes.data(), bytes.size());
+  }
+
+  char *begin() { return reinterpret_cast<char *>(words.data()); }
+  char *end() { return begin() + size; }
+
+  BinaryFormat::Header &header() {
+    return *reinterpret_cast<BinaryFormat::Header *>(begin());
+  }
+  uint64_t *offsets() {
+    return reinterpret_cast<uint64_t *>(begin() + sizeof(BinaryFormat::Header));
+  }
+  uint32_t *neighbors() {
+    return reinterpret_cast<uint32_t *>(offsets() + header().n + 1);
+  }
+
+  std::string tryParse(BinaryFormat::View &view) {
+    return BinaryFormat::tryParse(begin(), end(), view);
+  }
+};
+
+std::string readFile(const std::string &path) {
+  std::ifstream in(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(in), {});
+}
+
+/**
+   Write the adjacency array to a temporary file in the binary format and
+   return its contents.
+ */
+Bytes written(uint64_t n, const std::vector<uint64_t> &offsets,
+              const std::vector<uint32_t> &neighbors) {
+  const std::string path = testing::TempDir() + "/binary_format_test.graph";
+  BinaryFormat::write(path, n, offsets.data(), neighbors.data());
+  return Bytes(readFile(path));
+}
+
+/**
+   Triangle '{0,1,2}' with a pendant vertex '3' attached to '2'.
+ */
+const std::vector<uint64_t> offsets = {0, 2, 4, 7, 8};
+const std::vector<uint32_t> neighbors = {1, 2, 0, 2, 0, 1, 3, 2};
+
+TEST(BinaryFormat, RoundTrip) {
+  auto bytes = written(4, offsets, neighbors);
+  EXPECT_EQ(bytes.size, sizeof(BinaryFormat::Header) + 5 * 8 + 8 * 4);
+  EXPECT_TRUE(BinaryFormat::matches(bytes.begin(), bytes.end()));
+
+  const auto view = BinaryFormat::parse(bytes.begin(), bytes.end());
+  EXPECT_EQ(view.n, 4u);
+  EXPECT_EQ(view.m, 4u);
+  EXPECT_EQ(std::vector<uint64_t>(view.offsets, view.offsets + 5), offsets);
+  EXPECT_EQ(std::vector<uint32_t>(view.neighbors, view.neighbors + 8),
+            neighbors);
+}
+
+TEST(BinaryFormat, RoundTripEmpty) {
+  auto bytes = written(0, {0}, {});
+  const auto view = BinaryFormat::parse(bytes.begin(), bytes.end());
+  EXPECT_EQ(view.n, 0u);
+  EXPECT_EQ(view.m, 0u);
+}
+
+/**
+   Self-loops are dropped and adjacency lists sorted when writing an
+   'Undirected::Graph'.
+ */
+TEST(BinaryFormat, RoundTripGraph) {
+  const std::vector<Undirected::Edge> es = {{2, 0}, {0, 1}, {1, 1}, {2, 1},
+                                            {3, 2}};
+  const Undirected::Graph g(4, es);
+  const std::string path = testing::TempDir() + "/binary_format_test.graph";
+  BinaryFormat::write(path, g);
+
+  Bytes bytes(readFile(path));
+  const auto view = BinaryFormat::parse(bytes.begin(), bytes.end());
+  EXPECT_EQ(std::vector<uint64_t>(view.offsets, view.offsets + 5), offsets);
+  EXPECT_EQ(std::vector<uint32_t>(view.neighbors, view.neighbors + 8),
+            neighbors);
+}
+
+TEST(BinaryFormat, MissingHeader) {
+  auto bytes = written(4, offsets, neighbors);
+  BinaryFormat::View view;
+  EXPECT_EQ(BinaryFormat::tryParse(bytes.begin(), bytes.begin() + 31, view),
+            "Binary graph is missing header.");
+}
+
+TEST(BinaryFormat, BadMagic) {
+  auto bytes = written(4, offsets, neighbors);
+  bytes.header().magic[7] = 'X';
+  BinaryFormat::View view;
+  EXPECT_FALSE(BinaryFormat::matches(bytes.begin(), bytes.end()));
+  EXPECT_EQ(bytes.tryParse(view), "Binary graph has incorrect magic.");
+}
+
+TEST(BinaryFormat, BadVersionAndFlags) {
+  auto bytes = written(4, offsets, neighbors);
+  BinaryFormat::View view;
+  bytes.header().version = BinaryFormat::version + 1;
+  EXPECT_EQ(bytes.tryParse(view), "Unsupported binary graph version.");
+  bytes.header().version = BinaryFormat::version;
+  bytes.header().flags = 1;
+  EXPECT_EQ(bytes.tryParse(view), "Unsupported binary graph flags.");
+}
+
+/**
+   Headers whose sizes disagree with the data should be rejected without
+   reading past its end, including sizes chosen to overflow 'byteSize'.
+ */
+TEST(BinaryFormat, SizeMismatch) {
+  BinaryFormat::View view;
+  for (const auto &[n, m] : std::vector<std::pair<uint64_t, uint64_t>>{
+           {5, 4}, {3, 4}, {4, 3}, {4, 5}, {4, UINT64_MAX / 4}}) {
+    auto bytes = written(4, offsets, neighbors);
+    bytes.header().n = n;
+    bytes.header().m = m;
+    EXPECT_EQ(bytes.tryParse(view), "Binary graph has incorrect size.")
+        << "n = " << n << ", m = " << m;
+  }
+
+  auto bytes = written(4, offsets, neighbors);
+  bytes.header().n = uint64_t(UINT32_MAX) + 2;
+  EXPECT_EQ(bytes.tryParse(view), "Too many vertices for 32-bit neighbors.");
+}
+
+TEST(BinaryFormat, TruncatedNeighbors) {
+  auto bytes = written(4, offsets, neighbors);
+  BinaryFormat::View view;
+  for (size_t cut : {1, 4, 31})
+    EXPECT_EQ(BinaryFormat::tryParse(bytes.begin(), bytes.end() - cut, view),
+              "Binary graph has incorrect size.");
+}
+
+TEST(BinaryFormat, CorruptOffsets) {
+  BinaryFormat::View view;
+  {
+    auto bytes = written(4, offsets, neighbors);
+    bytes.offsets()[0] = 1;
+    EXPECT_EQ(bytes.tryParse(view), "First offset should be zero.");
+  }
+  {
+    auto bytes = written(4, offsets, neighbors);
+    bytes.offsets()[4] = 6;
+    EXPECT_EQ(bytes.tryParse(view),
+              "Last offset should equal the number of edge endpoints.");
+  }
+  {
+    auto bytes = written(4, offsets, neighbors);
+    bytes.offsets()[2] = 1;
+    EXPECT_EQ(bytes.tryParse(view), "Offsets should be non-decreasing.");
+  }
+}
+
+TEST(BinaryFormat, CorruptNeighbors) {
+  BinaryFormat::View view;
+  {
+    auto bytes = written(4, offsets, neighbors);
+    bytes.neighbors()[6] = 4;
+    EXPECT_EQ(bytes.tryParse(view), "Neighbor out of range.");
+  }
+  {
+    auto bytes = written(4, offsets, neighbors);
+    bytes.neighbors()[0] = 0;
+    EXPECT_EQ(bytes.tryParse(view), "Self-loops are not allowed.");
+  }
+  {
+    auto bytes = written(4, offsets, neighbors);
+    std::swap(bytes.neighbors()[0], bytes.neighbors()[1]);
+    EXPECT_EQ(bytes.tryParse(view), "Adjacency list of 0 is not sorted.");
+  }
+  {
+    auto bytes = written(4, offsets, neighbors);
+    bytes.neighbors()[7] = 1;
+    EXPECT_EQ(bytes.tryParse(view), "Edge (2, 3) has no reverse.");
+  }
+  {
+    // Edges '(1,0)' and '(2,0)' are only listed by their larger endpoint.
+    auto bytes = written(3, {0, 0, 1, 2}, {0, 0});
+    EXPECT_EQ(bytes.tryParse(view),
+              "Vertex 1 has an edge without a reverse.");
+  }
+}
@@ -0,0 +1,467 @@
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <fstream>
+#include <lzma.h>
+#include <random>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+#include "main/input.hpp"
+
+/**
+   Return all integers in 's' as parsed by 'nextInteger'.
+ */
+std::vector<int> integers(const std::string &s) {
+  std::vector<int> result;
+  const char *it = s.data(), *end = s.data() + s.size();
+  int x;
+  while (Input::nextInteger(it, end, x))
+    result.push_back(x);
+  return result;
+}
+
+TEST(NextInteger, SkipsSeparators) {
+  EXPECT_EQ(integers(""), std::vector<int>{});
+  EXPECT_EQ(integers(" \n\t "), std::vector<int>{});
+  EXPECT_EQ(integers("3 1\n0 1\n"), (std::vector<int>{3, 1, 0, 1}));
+  EXPECT_EQ(integers("  12,34\r\n5"), (std::vector<int>{12, 34, 5}));
+  EXPECT_EQ(integers("2147483647"), std::vector<int>{INT32_MAX});
+}
+
+/**
+   A '-' not directly followed by digits is a separator.
+ */
+TEST(NextInteger, DashAsSeparator) {
+  EXPECT_EQ(integers("1 - 2"), (std::vector<int>{1, 2}));
+  EXPECT_EQ(integers("1-\n2"), (std::vector<int>{1, 2}));
+}
+
+TEST(NextIntegerDeathTest, RejectsNegative) {
+  EXPECT_DEATH(integers("3 1\n0 -1\n"), "-1");
+}
+
+TEST(NextIntegerDeathTest, RejectsIntegerLargerThanInt) {
+  EXPECT_DEATH(integers("2147483648"), "2147483647");
+}
+
+/**
+   Chunks should be non-empty, cover the input in order and only end directly
+   after a newline or at the end of input.
+ */
+TEST(SplitLines, ChunksEndAtNewlines) {
+  std::string s;
+  for (int i = 0; i < 1000; ++i)
+    s += std::to_string(i) + " " + std::to_string(i * 7) + "\n";
+  s += "1 2";
+  const char *begin = s.data(), *end = s.data() + s.size();
+
+  for (int k : {1, 2, 3, 7, 64, 100000}) {
+    const auto chunks = Input::splitLines(begin, end, k);
+    ASSERT_FALSE(chunks.empty());
+    EXPECT_LE(int(chunks.size()), k);
+    EXPECT_EQ(chunks.front().first, begin);
+    EXPECT_EQ(chunks.back().second, end);
+    for (size_t i = 0; i < chunks.size(); ++i) {
+      EXPECT_LT(chunks[i].first, chunks[i].second);
+      if (i + 1 < chunks.size()) {
+        EXPECT_EQ(chunks[i].second, chunks[i + 1].first);
+        EXPECT_EQ(chunks[i].second[-1], '\n');
+      }
+    }
+  }
+}
+
+TEST(SplitLines, SingleLongLine) {
+  const std::string s(1000, '1');
+  const auto chunks = Input::splitLines(s.data(), s.data() + s.size(), 8);
+  ASSERT_EQ(chunks.size(), 1u);
+  EXPECT_EQ(chunks[0].first, s.data());
+  EXPECT_EQ(chunks[0].second, s.data() + s.size());
+}
+
+TEST(SplitLines, EmptyInput) {
+  const char *s = "";
+  EXPECT_TRUE(Input::splitLines(s, s, 4).empty());
+}
+
+/**
+   Radix sort should agree with 'std::sort' on keys of at most 'bits' bits,
+   regardless of the number of threads and whether 'bits' is a multiple of the
+   bits sorted per pass.
+ */
+TEST(RadixSort, MatchesStdSort) {
+  std::mt19937_64 gen(0);
+  for (int bits : {1, 8, 11, 20, 22, 40, 62}) {
+    const uint64_t mask = (uint64_t(1) << bits) - 1;
+    for (size_t size : {size_t(0), size_t(1), size_t(1000), size_t(300000)}) {
+      std::vector<uint64_t> keys(size);
+      for (auto &key : keys)
+        key = gen() & mask;
+      auto expected = keys;
+      std::sort(expected.begin(), expected.end());
+
+      for (int threads : {1, 2, 3, 8}) {
+        auto sorted = keys;
+        Input::radixSort(sorted, bits, threads);
+        EXPECT_EQ(sorted, expected)
+            << "bits = " << bits << ", size = " << size
+            << ", threads = " << threads;
+      }
+    }
+  }
+}
+
+/**
+   Adjacency lists of 'g', one vector per vertex.
+ */
+std::vector<std::vector<uint32_t>> lists(const Input::Adjacency &g) {
+  std::vector<std::vector<uint32_t>> result(g.offsets.size() - 1);
+  for (size_t u = 0; u + 1 < g.offsets.size(); ++u)
+    result[u].assign(g.neighbors.begin() + g.offsets[u],
+                     g.neighbors.begin() + g.offsets[u + 1]);
+  return result;
+}
+
+TEST(FromEdgeList, RemovesDuplicatesAndSelfLoops) {
+  std::vector<int> pairs = {3, 1, 0, 2, 1, 3, 2, 2, 2, 0, 1, 0,
+                            4, 4, 3, 1, 0, 1, 3, 0};
+  const auto g = Input::fromEdgeList(5, pairs, pairs.size() / 2, 2);
+  const std::vector<std::vector<uint32_t>> expected = {
+      {1, 2, 3}, {0, 3}, {0}, {0, 1}, {}};
+  EXPECT_EQ(lists(g), expected);
+  EXPECT_EQ(g.offsets.back(), g.neighbors.size());
+  EXPECT_TRUE(pairs.empty());
+}
+
+/**
+   Only the first 'm' pairs are edges.
+ */
+TEST(FromEdgeList, IgnoresPairsBeyondM) {
+  std::vector<int> pairs = {0, 1, 1, 2};
+  const auto g = Input::fromEdgeList(3, pairs, 1, 1);
+  const std::vector<std::vector<uint32_t>> expected = {{1}, {0}, {}};
+  EXPECT_EQ(lists(g), expected);
+}
+
+/**
+   Random multigraphs given in random order should give sorted adjacency lists
+   equal to those of the set of edges, for any number of threads.
+ */
+TEST(FromEdgeList, SortedForUnsortedInput) {
+  std::mt19937 gen(0);
+  for (int n : {1, 2, 100, 5000}) {
+    std::uniform_int_distribution<int> vertex(0, n - 1);
+    const size_t m = size_t(n) * 20;
+    std::vector<int> input(2 * m);
+    for (auto &x : input)
+      x = vertex(gen);
+
+    std::vector<std::vector<uint32_t>> expected(n);
+    for (size_t i = 0; i < m; ++i)
+      if (const int u = input[2 * i], v = input[2 * i + 1]; u != v)
+        expected[u].push_back(uint32_t(v)), expected[v].push_back(uint32_t(u));
+    for (auto &list : expected) {
+      std::sort(list.begin(), list.end());
+      list.erase(std::unique(list.begin(), list.end()), list.end());
+    }
+
+    for (int threads : {1, 4}) {
+      auto pairs = input;
+      const auto g = Input::fromEdgeList(n, pairs, m, threads);
+      EXPECT_EQ(lists(g), expected) << "n = " << n << ", threads = " << threads;
+    }
+  }
+}
+
+/**
+   Write 'text' to a temporary file and read it with 'reader' using 'threads'
+   threads.
+ */
+template <typename Reader>
+Input::Adjacency readText(Reader reader, const std::string &text,
+                          int threads = 2) {
+  const std::string path = testing::TempDir() + "/input_test.txt";
+  std::ofstream(path, std::ios::binary) << text;
+  auto source = Input::Source::open(path);
+  return reader(*source, threads);
+}
+
+/**
+   Triangle '{0,1,2}' followed by the path '2-3-4'.
+ */
+const std::vector<std::vector<uint32_t>> fixtureGraph = {
+    {1, 2}, {0, 2}, {0, 1, 3}, {2, 4}, {3}};
+
+const std::string fixtureEdgeList = "5 5\n"
+                                    "0 1\n"
+                                    "2 0\n"
+                                    "1 2\n"
+                                    "2 3\n"
+                                    "4 3\n";
+
+TEST(ReadEdgeList, Fixture) {
+  EXPECT_EQ(lists(readText(Input::readEdgeList, fixtureEdgeList)),
+            fixtureGraph);
+  EXPECT_EQ(lists(readText(Input::readEdgeList,
+                           "# comment\n5 5\n# comment\n0 1 2 0\n1 2\n"
+                           "2 3 4 3")),
+            fixtureGraph);
+}
+
+TEST(ReadMetis, Fixture) {
+  const std::string text = "% comment\n"
+                           "5 5\n"
+                           "2 3\n"
+                           "1 3\n"
+                           "% comment\n"
+                           "1 2 4\n"
+                           "3 5\n"
+                           "4\n";
+  EXPECT_EQ(lists(readText(Input::readMetis, text)), fixtureGraph);
+}
+
+/**
+   With 'fmt' set to '011' and 'ncon' to '2', each line starts with two vertex
+   weights and every neighbor is followed by an edge weight.
+ */
+TEST(ReadMetis, VertexAndEdgeWeights) {
+  const std::string text = "5 5 011 2\n"
+                           "7 8 2 10 3 11\n"
+                           "7 8 1 10 3 12\n"
+                           "7 8 1 11 2 12 4 13\n"
+                           "7 8 3 13 5 14\n"
+                           "7 8 4 14\n";
+  EXPECT_EQ(lists(readText(Input::readMetis, text)), fixtureGraph);
+}
+
+/**
+   With 'fmt' set to '110' each line starts with a vertex size and a single
+   vertex weight.
+ */
+TEST(ReadMetis, VertexSizesAndWeights) {
+  const std::string text = "5 5 110\n"
+                           "1 9 2 3\n"
+                           "1 9 1 3\n"
+                           "1 9 1 2 4\n"
+                           "1 9 3 5\n"
+                           "1 9 4\n";
+  EXPECT_EQ(lists(readText(Input::readMetis, text)), fixtureGraph);
+}
+
+/**
+   Isolated vertices are empty lines, and lines beyond the 'n' vertices are
+   ignored.
+ */
+TEST(ReadMetis, EmptyLines) {
+  const std::string text = "4 1\n"
+                           "\n"
+                           "3\n"
+                           "2\n"
+                           "\n"
+                           "1\n";
+  const std::vector<std::vector<uint32_t>> expected = {{}, {2}, {1}, {}};
+  EXPECT_EQ(lists(readText(Input::readMetis, text)), expected);
+}
+
+/**
+   Symmetric matrices list each edge once. Values, including negative ones, are
+   ignored and indices are 1-indexed.
+ */
+TEST(ReadMatrixMarket, Symmetric) {
+  const std::string text = "%%MatrixMarket matrix coordinate real symmetric\n"
+                           "% comment\n"
+                           "5 5 5\n"
+                           "2 1 0.5\n"
+                           "3 1 -1.5\n"
+                           "3 2 2\n"
+                           "% comment\n"
+                           "4 3 1e-3\n"
+                           "5 4 7\n";
+  EXPECT_EQ(lists(readText(Input::readMatrixMarket, text)), fixtureGraph);
+}
+
+/**
+   General matrices list both directions of each edge, and diagonal entries are
+   self-loops which are removed.
+ */
+TEST(ReadMatrixMarket, General) {
+  const std::string text = "%%MatrixMarket matrix coordinate pattern general\n"
+                           "5 5 12\n"
+                           "1 2\n2 1\n1 3\n3 1\n2 3\n3 2\n"
+                           "3 3\n"
+                           "3 4\n4 3\n4 5\n5 4\n"
+                           "1 2\n";
+  EXPECT_EQ(lists(readText(Input::readMatrixMarket, text)), fixtureGraph);
+}
+
+TEST(ReadMatrixMarketDeathTest, RejectsArrayFormat) {
+  EXPECT_DEATH(readText(Input::readMatrixMarket,
+                        "%%MatrixMarket matrix array real general\n2 2\n"),
+               "coordinate");
+}
+
+/**
+   Sparse identifiers are relabelled in increasing order, and columns after
+   the first two are ignored.
+ */
+TEST(ReadSnap, CompactsIds) {
+  const std::string text = "# Directed graph\n"
+                           "# Nodes: 5 Edges: 5\n"
+                           "10\t20\n"
+                           "35\t10\t3\n"
+                           "20\t35\n"
+                           "# comment\n"
+                           "35\t1000\n"
+                           "99999\t1000\n";
+  EXPECT_EQ(lists(readText(Input::readSnap, text)), fixtureGraph);
+}
+
+/**
+   Every encoding of the fixture graph should read to the same adjacency
+   regardless of the number of threads.
+ */
+TEST(Readers, AgreeWithEdgeList) {
+  for (int threads : {1, 4}) {
+    const auto expected = readText(Input::readEdgeList, fixtureEdgeList);
+    const auto metis =
+        readText(Input::readMetis, "5 5\n2 3\n1 3\n1 2 4\n3 5\n4\n", threads);
+    const auto mtx = readText(Input::readMatrixMarket,
+                              "5 5 5\n1 2\n1 3\n2 3\n3 4\n4 5\n", threads);
+    const auto snap =
+        readText(Input::readSnap, "7 9\n7 8\n8 9\n9 11\n11 12\n", threads);
+    for (const auto *g : {&metis, &mtx, &snap}) {
+      EXPECT_EQ(g->offsets, expected.offsets);
+      EXPECT_EQ(g->neighbors, expected.neighbors);
+    }
+  }
+}
+
+TEST(CompactIds, PreservesOrder) {
+  std::vector<int> ids = {100, 5, 64, 5, 63, 1 << 20, 0, 64};
+  EXPECT_EQ(Input::compactIds(ids, 2), 6);
+  EXPECT_EQ(ids, (std::vector<int>{4, 1, 3, 1, 2, 5, 0, 3}));
+}
+
+/**
+   Edge list of a random graph with 'n' vertices and 'm' edges.
+ */
+std::string randomEdgeList(int n, int m) {
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int> vertex(0, n - 1);
+  std::string text = std::to_string(n) + " " + std::to_string(m) + "\n";
+  for (int i = 0; i < m; ++i)
+    text += std::to_string(vertex(gen)) + " " + std::to_string(vertex(gen)) +
+            "\n";
+  return text;
+}
+
+std::string gzip(const std::string &text) {
+  z_stream stream = {};
+  // Window bits '15 + 16' writes a gzip header.
+  EXPECT_EQ(deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16,
+                         8, Z_DEFAULT_STRATEGY),
+            Z_OK);
+  std::string result(deflateBound(&stream, uLong(text.size())), '\0');
+  stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(text.data()));
+  stream.avail_in = uInt(text.size());
+  stream.next_out = reinterpret_cast<Bytef *>(result.data());
+  stream.avail_out = uInt(result.size());
+  EXPECT_EQ(deflate(&stream, Z_FINISH), Z_STREAM_END);
+  result.resize(stream.total_out);
+  deflateEnd(&stream);
+  return result;
+}
+
+std::string xz(const std::string &text) {
+  std::string result(lzma_stream_buffer_bound(text.size()), '\0');
+  size_t size = 0;
+  EXPECT_EQ(lzma_easy_buffer_encode(
+                1, LZMA_CHECK_CRC64, nullptr,
+                reinterpret_cast<const uint8_t *>(text.data()), text.size(),
+                reinterpret_cast<uint8_t *>(result.data()), &size,
+                result.size()),
+            LZMA_OK);
+  result.resize(size);
+  return result;
+}
+
+/**
+   Write 'bytes' to a temporary file and open it as a source.
+ */
+std::unique_ptr<Input::Source> openBytes(const std::string &bytes) {
+  const std::string path = testing::TempDir() + "/input_test.bin";
+  std::ofstream(path, std::ios::binary) << bytes;
+  return Input::Source::open(path);
+}
+
+/**
+   Consume a source in steps of 'step' bytes, filling the window whenever fewer
+   remain, and return everything consumed. Leaving unconsumed input in the
+   window makes 'fill' move it to the front before appending the next block.
+ */
+std::string drain(Input::Source &source, size_t step) {
+  std::string result;
+  while (true) {
+    source.fill(step);
+    const size_t size =
+        std::min(step, size_t(source.end() - source.begin()));
+    if (size == 0)
+      break;
+    result.append(source.begin(), size);
+    source.consume(source.begin() + size);
+  }
+  return result;
+}
+
+/**
+   Compressed inputs should decompress to the original bytes, including inputs
+   spanning several blocks and gzip files of several concatenated members.
+ */
+TEST(Source, DecompressesInput) {
+  const std::string small = fixtureEdgeList;
+  const std::string large = randomEdgeList(100000, 500000);
+  ASSERT_GT(large.size(), size_t(5 << 20));
+
+  for (const auto &text : {small, large}) {
+    for (const auto &bytes : {gzip(text), xz(text)}) {
+      for (size_t step : {size_t(3 << 20), size_t(1000003)}) {
+        auto source = openBytes(bytes);
+        EXPECT_TRUE(drain(*source, step) == text)
+            << "size = " << text.size() << ", step = " << step;
+      }
+      auto source = openBytes(bytes);
+      source->fillAll();
+      EXPECT_TRUE(std::string(source->begin(), source->end()) == text);
+    }
+  }
+
+  const std::string half = large.substr(0, large.size() / 2);
+  auto source = openBytes(gzip(half) + gzip(large.substr(half.size())));
+  EXPECT_TRUE(drain(*source, 1 << 20) == large);
+}
+
+/**
+   Reading a compressed graph should give the same adjacency as reading the
+   uncompressed, memory mapped file.
+ */
+TEST(Source, CompressedGraphMatchesUncompressed) {
+  const std::string text = randomEdgeList(100000, 500000);
+  const auto expected = Input::readEdgeList(*openBytes(text), 4);
+  ASSERT_EQ(expected.offsets.size(), 100001u);
+
+  for (const auto &bytes : {gzip(text), xz(text)}) {
+    for (int threads : {1, 4}) {
+      const auto g = Input::readEdgeList(*openBytes(bytes), threads);
+      EXPECT_EQ(g.offsets, expected.offsets);
+      EXPECT_EQ(g.neighbors, expected.neighbors);
+    }
+  }
+}
+
+TEST(SourceDeathTest, TruncatedGzip) {
+  const std::string bytes = gzip(randomEdgeList(1000, 10000));
+  EXPECT_DEATH(openBytes(bytes.substr(0, bytes.size() / 2))->fillAll(),
+               "truncated");
+}
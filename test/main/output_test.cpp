@@ -0,0 +1,109 @@
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "main/output.hpp"
+
+/**
+   Write a decomposition in the binary format through a pipe and return the
+   bytes written.
+ */
+template <typename V>
+std::string binary(long long edgesCut, const std::vector<V> &partitionOf,
+                   const std::vector<double> &conductances) {
+  int fds[2];
+  EXPECT_EQ(pipe(fds), 0);
+  {
+    Output::Writer out(fds[1]);
+    Output::writeBinary(out, edgesCut, partitionOf, conductances);
+  }
+  close(fds[1]);
+
+  std::string bytes;
+  char block[4096];
+  for (ssize_t count; (count = read(fds[0], block, sizeof(block))) > 0;)
+    bytes.append(block, size_t(count));
+  close(fds[0]);
+  return bytes;
+}
+
+/**
+   Read a value of type 'T' at byte 'offset' of 'bytes'.
+ */
+template <typename T> T at(const std::string &bytes, size_t offset) {
+  T x;
+  EXPECT_LE(offset + sizeof(T), bytes.size());
+  std::memcpy(&x, bytes.data() + offset, sizeof(T));
+  return x;
+}
+
+/**
+   Check the header, partition indices, padding and conductances of 'bytes'
+   against the decomposition they were written from.
+ */
+template <typename V>
+void expectLayout(const std::string &bytes, long long edgesCut,
+                  const std::vector<V> &partitionOf,
+                  const std::vector<double> &conductances) {
+  const size_t n = partitionOf.size(), k = conductances.size();
+  const size_t padding = n % 2 == 1 ? 4 : 0;
+  const size_t conductancesBegin = 40 + 4 * n + padding;
+  ASSERT_EQ(bytes.size(), conductancesBegin + 8 * k);
+  EXPECT_EQ(conductancesBegin % 8, 0u);
+
+  EXPECT_EQ(bytes.substr(0, 8), "EDCPARTS");
+  EXPECT_EQ(at<uint32_t>(bytes, 8), Output::BinaryPartition::version);
+  EXPECT_EQ(at<uint32_t>(bytes, 12), 0u);
+  EXPECT_EQ(at<uint64_t>(bytes, 16), n);
+  EXPECT_EQ(at<uint64_t>(bytes, 24), k);
+  EXPECT_EQ(at<uint64_t>(bytes, 32), uint64_t(edgesCut));
+
+  for (size_t i = 0; i < n; ++i)
+    EXPECT_EQ(at<int32_t>(bytes, 40 + 4 * i), int32_t(partitionOf[i]));
+  if (padding > 0) {
+    EXPECT_EQ(at<uint32_t>(bytes, 40 + 4 * n), 0u);
+  }
+  for (size_t i = 0; i < k; ++i)
+    EXPECT_EQ(at<double>(bytes, conductancesBegin + 8 * i), conductances[i]);
+}
+
+TEST(BinaryPartition, EvenNumberOfVertices) {
+  const std::vector<int32_t> partitionOf = {0, 1, 1, 0};
+  const std::vector<double> conductances = {0.5, 0.25};
+  expectLayout(binary(3, partitionOf, conductances), 3, partitionOf,
+               conductances);
+}
+
+TEST(BinaryPartition, OddNumberOfVertices) {
+  const std::vector<int32_t> partitionOf = {2, 0, 1, 1, 2};
+  const std::vector<double> conductances = {0.125, 1.0, 0.75};
+  expectLayout(binary(7, partitionOf, conductances), 7, partitionOf,
+               conductances);
+}
+
+TEST(BinaryPartition, Empty) {
+  expectLayout(binary(0, std::vector<int32_t>{}, {}), 0,
+               std::vector<int32_t>{}, {});
+}
+
+/**
+   64-bit partition indices are narrowed to 32 bits in chunks, so use more
+   vertices than fit in a single chunk.
+ */
+TEST(BinaryPartition, Int64Indices) {
+  for (size_t n : {size_t(6), size_t(9), size_t(10001), size_t(10002)}) {
+    std::vector<int64_t> partitionOf(n);
+    for (size_t i = 0; i < n; ++i)
+      partitionOf[i] = int64_t(i % 3);
+    const std::vector<double> conductances = {0.1, 0.2, 0.3};
+
+    const auto bytes = binary(42, partitionOf, conductances);
+    expectLayout(bytes, 42, partitionOf, conductances);
+
+    std::vector<int32_t> narrowed(partitionOf.begin(), partitionOf.end());
+    EXPECT_EQ(bytes, binary(42, narrowed, conductances)) << "n = " << n;
+  }
+}
@@ -0,0 +1,194 @@
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "main/binary_format.hpp"
+#include "main/server.hpp"
+
+/**
+   Parameters of the balanced cut strategy used by 'edc-server' by default.
+ */
+const CutMatching::Parameters params = {.tConst = 22,
+                                        .tFactor = 5.0,
+                                        .minIterations = 0,
+                                        .minBalance = 0.45,
+                                        .samplePotential = false,
+                                        .balancedCutStrategy = true};
+
+/**
+   Connection timeout used by tests which expect the server to give up on a
+   client.
+ */
+const Server::Clock::duration timeout = std::chrono::milliseconds(50);
+
+/**
+   Header of a graph in the binary format with 'n' vertices and 'm' edges.
+ */
+BinaryFormat::Header header(uint64_t n, uint64_t m) {
+  BinaryFormat::Header h;
+  std::memcpy(h.magic, BinaryFormat::magic, sizeof(BinaryFormat::magic));
+  h.version = BinaryFormat::version;
+  h.flags = 0;
+  h.n = n;
+  h.m = m;
+  return h;
+}
+
+/**
+   Send 'bytes' to a server with 'options' over a connected socket pair,
+   closing the client side once sent unless 'keepOpen' is set. Return the
+   response.
+ */
+std::string request(const std::string &bytes, const Server::Options &options,
+                    Server::State &state, std::vector<uint64_t> &buffer,
+                    bool keepOpen = false) {
+  int fds[2];
+  EXPECT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  EXPECT_EQ(write(fds[0], bytes.data(), bytes.size()), ssize_t(bytes.size()));
+  if (!keepOpen)
+    shutdown(fds[0], SHUT_WR);
+
+  std::mt19937 randomGen(0);
+  ExpanderDecomposition::Solver solver(0.01, &randomGen, params);
+  Server::serve(state, {fds[1], Server::Clock::now()}, options, solver,
+                randomGen, buffer);
+  close(fds[1]);
+
+  std::string response;
+  char block[4096];
+  for (ssize_t count; (count = read(fds[0], block, sizeof(block))) > 0;)
+    response.append(block, size_t(count));
+  close(fds[0]);
+  return response;
+}
+
+/**
+   Request with a triangle in the binary format.
+ */
+std::string triangle() {
+  const auto h = header(3, 3);
+  const uint64_t offsets[] = {0, 2, 4, 6};
+  const uint32_t neighbors[] = {1, 2, 0, 2, 0, 1};
+  std::string bytes(reinterpret_cast<const char *>(&h), sizeof(h));
+  bytes.append(reinterpret_cast<const char *>(offsets), sizeof(offsets));
+  bytes.append(reinterpret_cast<const char *>(neighbors), sizeof(neighbors));
+  return bytes;
+}
+
+/**
+   A valid graph should be answered with its decomposition, after which the
+   connection is closed by the client.
+ */
+TEST(Server, AnswersGraph) {
+  const auto bytes = triangle();
+
+  Server::State state;
+  std::vector<uint64_t> buffer;
+  const auto response = request(bytes, {.seed = 1, .maxRequestBytes = 1024},
+                                state, buffer);
+  EXPECT_FALSE(response.empty());
+  EXPECT_EQ(state.completed, 1);
+  EXPECT_EQ(state.failed, 0);
+}
+
+/**
+   A header announcing a graph larger than the request limit should close the
+   connection before any memory for the graph is allocated.
+ */
+TEST(Server, RejectsOversizedHeader) {
+  const auto h = header(100'000'000, 1'000'000'000);
+  const std::string bytes(reinterpret_cast<const char *>(&h), sizeof(h));
+
+  Server::State state;
+  std::vector<uint64_t> buffer;
+  const auto response =
+      request(bytes, {.seed = 1, .maxRequestBytes = 1 << 20}, state, buffer);
+  EXPECT_TRUE(response.empty());
+  EXPECT_EQ(state.completed, 0);
+  EXPECT_EQ(state.failed, 1);
+  EXPECT_EQ(buffer.capacity(), 0u);
+}
+
+/**
+   Graphs whose subdivision graph cannot be indexed by the solver should be
+   rejected, regardless of the request limit.
+ */
+TEST(Server, RejectsTooManyVerticesAndEdges) {
+  for (const auto &[n, m] : std::vector<std::pair<uint64_t, uint64_t>>{
+           {2'000'000'000, 200'000'000},
+           {UINT64_MAX, 1},
+           {1, UINT64_MAX}}) {
+    const auto h = header(n, m);
+    const std::string bytes(reinterpret_cast<const char *>(&h), sizeof(h));
+
+    Server::State state;
+    std::vector<uint64_t> buffer;
+    const auto response = request(
+        bytes, {.seed = 1, .maxRequestBytes = UINT64_MAX}, state, buffer);
+    EXPECT_TRUE(response.empty());
+    EXPECT_EQ(state.failed, 1);
+    EXPECT_EQ(buffer.capacity(), 0u);
+  }
+}
+
+/**
+   A client which connects but never sends a request should fail once the
+   timeout passes, rather than holding on to the worker.
+ */
+TEST(Server, TimesOutWithoutRequest) {
+  Server::State state;
+  std::vector<uint64_t> buffer;
+  const auto response = request(
+      "", {.seed = 1, .maxRequestBytes = 1024, .timeout = timeout}, state,
+      buffer, true);
+  EXPECT_TRUE(response.empty());
+  EXPECT_EQ(state.completed, 0);
+  EXPECT_EQ(state.failed, 1);
+}
+
+TEST(Server, TimesOutDuringRequest) {
+  const auto bytes = triangle();
+
+  Server::State state;
+  std::vector<uint64_t> buffer;
+  const auto response = request(
+      bytes.substr(0, bytes.size() - 1),
+      {.seed = 1, .maxRequestBytes = 1024, .timeout = timeout}, state, buffer,
+      true);
+  EXPECT_TRUE(response.empty());
+  EXPECT_EQ(state.completed, 0);
+  EXPECT_EQ(state.failed, 1);
+}
+
+/**
+   A connection left idle after its requests have been answered is closed
+   without failing a request.
+ */
+TEST(Server, IdleAfterRequestIsNotFailure) {
+  const auto bytes = triangle();
+
+  Server::State state;
+  std::vector<uint64_t> buffer;
+  const auto response = request(
+      bytes + bytes, {.seed = 1, .maxRequestBytes = 1024, .timeout = timeout},
+      state, buffer, true);
+  EXPECT_FALSE(response.empty());
+  EXPECT_EQ(state.completed, 2);
+  EXPECT_EQ(state.failed, 0);
+}
+
+TEST(Server, RejectsConnectionsBeyondQueueLimit) {
+  Server::State state;
+  EXPECT_TRUE(state.enqueue({3, Server::Clock::now()}, 2));
+  EXPECT_TRUE(state.enqueue({4, Server::Clock::now()}, 2));
+  EXPECT_FALSE(state.enqueue({5, Server::Clock::now()}, 2));
+  EXPECT_EQ(state.queue.size(), 2u);
+  EXPECT_EQ(state.rejected, 1);
+
+  state.queue.pop_front();
+  EXPECT_TRUE(state.enqueue({5, Server::Clock::now()}, 2));
+  EXPECT_EQ(state.queue.back().fd, 5);
+  EXPECT_EQ(state.rejected, 1);
+}
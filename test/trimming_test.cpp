@@ -0,0 +1,88 @@
+#include "gtest/gtest.h"
+
+#include "lib/trimming.hpp"
+
+#include <vector>
+
+/**
+   Trim the graph with 'n' vertices and 'edges' after removing the vertices in
+   'removed', and return every vertex which is not left, in increasing order.
+ */
+std::vector<int> trim(int n, const std::vector<std::pair<int, int>> &edges,
+                      const std::vector<int> &removed, double phi) {
+  std::vector<UnitFlow::Edge> es;
+  for (auto [u, v] : edges)
+    es.emplace_back(u, v, 0);
+  UnitFlow::Graph g(n, es);
+  for (auto u : removed)
+    g.remove(u);
+
+  Trimming::Solver solver(&g, phi);
+  solver.compute();
+
+  std::vector<int> result;
+  for (int u = 0; u < n; ++u)
+    if (!g.alive(u))
+      result.push_back(u);
+  return result;
+}
+
+/**
+   Clique '{0,1,2,3,4}' with the path '4-5-6-7-8' attached, and vertex '9'
+   adjacent to '7' and '8'.
+ */
+std::vector<std::pair<int, int>> cliqueWithPath() {
+  std::vector<std::pair<int, int>> edges;
+  for (int u = 0; u < 5; ++u)
+    for (int v = u + 1; v < 5; ++v)
+      edges.emplace_back(u, v);
+  for (int u = 4; u < 8; ++u)
+    edges.emplace_back(u, u + 1);
+  edges.emplace_back(7, 9);
+  edges.emplace_back(8, 9);
+  return edges;
+}
+
+/**
+   Removing '9' leaves the end of the path with more source than it can route
+   to the clique. Each level cut trimmed passes source on to its neighbors, so
+   the whole path is trimmed.
+ */
+TEST(Trimming, TrimsPathEnd) {
+  EXPECT_EQ(trim(10, cliqueWithPath(), {9}, 0.2),
+            std::vector<int>({5, 6, 7, 8, 9}));
+}
+
+/**
+   With enough edge capacity every vertex can route its source, so nothing
+   besides the removed vertex is trimmed.
+ */
+TEST(Trimming, KeepsRoutableVertices) {
+  EXPECT_EQ(trim(10, cliqueWithPath(), {9}, 0.5), std::vector<int>({9}));
+
+  const std::vector<std::pair<int, int>> edges = {
+      {0, 1}, {1, 2}, {0, 2}, {2, 3}, {3, 4}, {4, 5},
+      {5, 6}, {6, 7}, {5, 7}, {3, 8}, {4, 8}};
+  for (double phi : {0.5, 0.2, 0.05})
+    EXPECT_EQ(trim(9, edges, {8}, phi), std::vector<int>({8}));
+}
+
+/**
+   Removing two vertices of the top row of a 3x4 grid leaves their neighbors
+   with more source than the grid can absorb at phi = 0.2, and trimming
+   continues until only the edge between '6' and '10' is left.
+ */
+TEST(Trimming, TrimsGridCorner) {
+  std::vector<std::pair<int, int>> edges;
+  for (int r = 0; r < 3; ++r)
+    for (int c = 0; c < 4; ++c) {
+      const int u = 4 * r + c;
+      if (c < 3)
+        edges.emplace_back(u, u + 1);
+      if (r < 2)
+        edges.emplace_back(u, u + 4);
+    }
+  EXPECT_EQ(trim(12, edges, {0, 1}, 0.2),
+            std::vector<int>({0, 1, 2, 3, 4, 5, 7, 8, 9, 11}));
+  EXPECT_EQ(trim(12, edges, {0, 1}, 0.5), std::vector<int>({0, 1}));
+}